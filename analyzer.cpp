@@ -1,138 +1,205 @@
 #include "analyzer.h"
+#include "resolver.h"
+#include "specialized.h"
 namespace SBASIC
 {
-SyntaxAnalyer::SyntaxAnalyer(TokenReader & token_reader) : m_token_reader(token_reader), m_token_ptr(nullptr)
+inline namespace SBASIC_NUMERIC
+{
+//Binary operators, indexed by OPERATOR
+struct BinaryOperator
+{
+    OPERATOR op;
+    unsigned int precedence;
+    ASSOCIATIVITY associativity;
+};
+constexpr BinaryOperator BINARY_OPERATORS[] =
+{
+    {OPERATOR::PLUS,4,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::SUBSTRACT,4,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::MULTIPLY,6,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::DIVIDE,6,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::DIVIDE_EXACTLY,6,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::POWER,7,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::MOD,5,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::EQUAL,3,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::GREATER_THEN,3,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::LESS_THEN,3,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::NOT_EQUAL,3,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::GREATER_THEN_OR_EQUAL,3,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::LESS_THEN_OR_EQUAL,3,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::AND,1,ASSOCIATIVITY::RIGHT},
+    {OPERATOR::OR,2,ASSOCIATIVITY::RIGHT},
+    //Prefix only
+    {OPERATOR::NOT,0,ASSOCIATIVITY::RIGHT}
+};
+
+constexpr bool is_binary_operator_table_ordered()
+{
+    for(std::size_t i = 0; i < sizeof(BINARY_OPERATORS) / sizeof(BINARY_OPERATORS[0]); ++i)
+    {
+        if(static_cast<std::size_t>(BINARY_OPERATORS[i].op) != i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(is_binary_operator_table_ordered(),"Binary operator table must follow OPERATOR");
+
+//0 if op is not a binary operator
+constexpr unsigned int binary_operator_precedence(OPERATOR op)
+{
+    return BINARY_OPERATORS[static_cast<std::size_t>(op)].precedence;
+}
+
+//Whether the pending left operator takes its operands before the incoming right one
+constexpr bool binds_before(OPERATOR left,OPERATOR right)
+{
+    const BinaryOperator & left_operator = BINARY_OPERATORS[static_cast<std::size_t>(left)];
+    const BinaryOperator & right_operator = BINARY_OPERATORS[static_cast<std::size_t>(right)];
+    return left_operator.precedence > right_operator.precedence || (left_operator.precedence == right_operator.precedence && right_operator.associativity == ASSOCIATIVITY::LEFT);
+}
+
+SyntaxAnalyer::SyntaxAnalyer(TokenReader & token_reader,const FunctionTable & function_table) : m_token_reader(token_reader), m_function_table(function_table), m_lookahead_begin(0), m_lookahead_count(0), m_arena_ptr(nullptr)
 {
     read_token();
 }
 
 void SyntaxAnalyer::read_token()
 {
-    if(m_token_ptr != nullptr)
+    if(m_lookahead_count != 0)
     {
-        delete m_token_ptr;
+        m_token = m_lookahead_tokens[m_lookahead_begin];
+        m_lookahead_begin = (m_lookahead_begin + 1) % LOOKAHEAD;
+        m_lookahead_count--;
+    }
+    else
+    {
+        m_token = m_token_reader.read_token();
     }
-    m_token_ptr = m_token_reader.read_token();
 }
 
-SyntaxAnalyer::~SyntaxAnalyer()
+const Token & SyntaxAnalyer::peek_token(unsigned int n)
 {
-    if(m_token_ptr != nullptr)
+    //n-th token after the current one, 1 <= n <= LOOKAHEAD
+    for(; m_lookahead_count < n; m_lookahead_count++)
     {
-        delete m_token_ptr;
+        m_lookahead_tokens[(m_lookahead_begin + m_lookahead_count) % LOOKAHEAD] = m_token_reader.read_token();
     }
+    return m_lookahead_tokens[(m_lookahead_begin + n - 1) % LOOKAHEAD];
 }
 
-Program * SyntaxAnalyer::analyer() throw(std::string)
+const char * SyntaxAnalyer::create_text(const Token & token)
+{
+    return m_arena_ptr->create_string(m_token_reader.get_text(token),token.get_text_length());
+}
+
+Program * SyntaxAnalyer::analyer()
 {
     Program * program_ptr = new Program();
-    std::vector<Stmt *> stmt_vector;
-    stmts(stmt_vector);
-    for(auto it = stmt_vector.begin(); it != stmt_vector.end(); ++it)
+    m_arena_ptr = &program_ptr->get_arena();
+    try
     {
-        program_ptr->add_stmt(*it);
+        std::vector<Stmt *> stmt_vector;
+        stmts(stmt_vector);
+        program_ptr->set_stmts(m_arena_ptr->create_list(stmt_vector));
+        if(!(m_token.is_keyword(KEYWORD::END)))
+        {
+            throw create_error("Not found END",m_token.get_line_number());
+        }
     }
-    if(!(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::END))
+    catch(...)
     {
-        throw create_error("Not found END",m_token_ptr->get_line_number());
+        //Nodes live in the program arena, dropping it frees the partial tree
+        m_arena_ptr = nullptr;
+        delete program_ptr;
+        throw;
     }
+    m_arena_ptr = nullptr;
+    VariableResolver variable_resolver;
+    variable_resolver.resolve(program_ptr);
     return program_ptr;
 }
 
-void SyntaxAnalyer::stmts(std::vector<Stmt *> & stmt_vector)throw (std::string)
+void SyntaxAnalyer::stmts(std::vector<Stmt *> & stmt_vector)
 {
-    Stmt * stmt_ptr = stmt();
-    if(stmt_ptr != nullptr)
+    //Loop instead of recursing per statement, the stack only grows with nesting
+    for(Stmt * stmt_ptr = stmt(); stmt_ptr != nullptr; stmt_ptr = stmt())
     {
         stmt_vector.push_back(stmt_ptr);
-        if(!(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::NEW_LINE))
+        if(!(m_token.is_delimiter(DELIMITER::NEW_LINE)))
         {
-            throw create_error("Lack of \\n",m_token_ptr->get_line_number());
-        }
-        else
-        {
-            read_token();
-            stmts(stmt_vector);
+            throw create_error("Lack of \\n",m_token.get_line_number());
         }
+        read_token();
     }
 }
 
-void SyntaxAnalyer::exps(std::vector<Expression *> & exp_vector)throw(std::string)
+void SyntaxAnalyer::exps(std::vector<Expression *> & exp_vector)
 {
     exp_vector.push_back(exp());
-    exp_tail(exp_vector);
-}
-
-void SyntaxAnalyer::exp_tail(std::vector<Expression *> & exp_vector)throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::COMMA)
+    while(m_token.is_delimiter(DELIMITER::COMMA))
     {
         read_token();
         exp_vector.push_back(exp());
-        exp_tail(exp_vector);
     }
 }
 
-Stmt * SyntaxAnalyer::stmt()throw (std::string)
+Stmt * SyntaxAnalyer::stmt()
 {
-    if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::PRINT)
+    //Blank lines
+    while(m_token.is_delimiter(DELIMITER::NEW_LINE))
+    {
+        read_token();
+    }
+    if(m_token.is_keyword(KEYWORD::PRINT))
     {
-        PrintStmt * print_stmt_ptr = new PrintStmt();
+        PrintStmt * print_stmt_ptr = m_arena_ptr->create<PrintStmt>();
         read_token();
-        if(m_token_ptr->get_token_type() == TOKEN::STRING_TOKEN)
+        if(m_token.get_token_type() == TOKEN::STRING_TOKEN)
         {
-            print_stmt_ptr->set_prompt(dynamic_cast<StringToken *>(m_token_ptr)->get_string());
+            print_stmt_ptr->set_prompt(create_text(m_token));
             read_token();
-            if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::SEMICOLON)
+            if(m_token.is_delimiter(DELIMITER::SEMICOLON))
             {
                 read_token();
                 std::vector<Expression *> exp_vector;
                 exps(exp_vector);
-                for(auto it = exp_vector.begin(); it != exp_vector.end(); ++it)
-                {
-                    print_stmt_ptr->add_expression(*it);
-                }
+                print_stmt_ptr->set_expressions(m_arena_ptr->create_list(exp_vector));
             }
         }
         else
         {
             std::vector<Expression *> exp_vector;
             exps(exp_vector);
-            for(auto it = exp_vector.begin(); it != exp_vector.end(); ++it)
-            {
-                print_stmt_ptr->add_expression(*it);
-            }
+            print_stmt_ptr->set_expressions(m_arena_ptr->create_list(exp_vector));
         }
         return print_stmt_ptr;
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::INPUT)
+    else if(m_token.is_keyword(KEYWORD::INPUT))
     {
-        InputStmt * input_stmt_ptr = new InputStmt();
+        InputStmt * input_stmt_ptr = m_arena_ptr->create<InputStmt>();
         read_token();
 
-        std::string * prompt_ptr = prompt();
+        const char * prompt_ptr = prompt();
         if(prompt_ptr != nullptr)
         {
-            input_stmt_ptr->set_prompt(*prompt_ptr);
-            delete prompt_ptr;
+            input_stmt_ptr->set_prompt(prompt_ptr);
         }
         std::vector<VariableExpression *> var_vector;
         ids(var_vector);
-        for(auto it = var_vector.begin(); it != var_vector.end(); ++it)
-        {
-            input_stmt_ptr->add_expression(*it);
-        }
+        input_stmt_ptr->set_expressions(m_arena_ptr->create_list(var_vector));
         return input_stmt_ptr;
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::IDENTIFIER_TOKEN)
+    else if(m_token.get_token_type() == TOKEN::IDENTIFIER_TOKEN)
     {
-        AssignmentStmt * assignment_stmt_ptr = new AssignmentStmt();
-        VariableExpression * var_exp_ptr = new VariableExpression();
-        var_exp_ptr->set_line_number(m_token_ptr->get_line_number());
-        var_exp_ptr->set_variable_name(dynamic_cast<IdentifierToken *>(m_token_ptr)->get_identifier());
+        AssignmentStmt * assignment_stmt_ptr = m_arena_ptr->create<AssignmentStmt>();
+        VariableExpression * var_exp_ptr = m_arena_ptr->create<VariableExpression>();
+        var_exp_ptr->set_line_number(m_token.get_line_number());
+        var_exp_ptr->set_variable_name(create_text(m_token));
         assignment_stmt_ptr->set_variable_expression(var_exp_ptr);
         read_token();
-        if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::EQUAL)
+        if(m_token.is_operator(OPERATOR::EQUAL))
         {
             read_token();
             assignment_stmt_ptr->set_expression(exp());
@@ -140,115 +207,103 @@ Stmt * SyntaxAnalyer::stmt()throw (std::string)
         }
         else
         {
-            throw create_error("Lack of =",m_token_ptr->get_line_number());
+            throw create_error("Lack of =",m_token.get_line_number());
         }
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::IF)
+    else if(m_token.is_keyword(KEYWORD::IF))
     {
-        SelectionStmt * selection_stmt_ptr = new SelectionStmt();
+        SelectionStmt * selection_stmt_ptr = m_arena_ptr->create<SelectionStmt>();
         read_token();
         selection_stmt_ptr->set_condition(exp());
-        if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::THEN)
+        if(m_token.is_keyword(KEYWORD::THEN))
         {
             read_token();
             read_token();
             std::vector<Stmt *> true_stmt_vector;
             stmts(true_stmt_vector);
-            for(auto it = true_stmt_vector.begin(); it != true_stmt_vector.end(); ++it)
-            {
-                selection_stmt_ptr->add_true_stmt(*it);
-            }
-            if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::ELSE)
+            selection_stmt_ptr->set_true_stmts(m_arena_ptr->create_list(true_stmt_vector));
+            if(m_token.is_keyword(KEYWORD::ELSE))
             {
                 read_token();
                 read_token();
                 std::vector<Stmt *> false_stmt_vector;
                 stmts(false_stmt_vector);
-                for(auto it = false_stmt_vector.begin(); it != false_stmt_vector.end(); ++it)
-                {
-                    selection_stmt_ptr->add_false_stmt(*it);
-                }
-                if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::END)
+                selection_stmt_ptr->set_false_stmts(m_arena_ptr->create_list(false_stmt_vector));
+                if(m_token.is_keyword(KEYWORD::END))
                 {
                     read_token();
-                    if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::IF)
+                    if(m_token.is_keyword(KEYWORD::IF))
                     {
                         read_token();
                         return selection_stmt_ptr;
                     }
                     else
                     {
-                        throw create_error("Lack of END IF",m_token_ptr->get_line_number());
+                        throw create_error("Lack of END IF",m_token.get_line_number());
                     }
                 }
                 else
                 {
-                    throw create_error("Lack of END IF",m_token_ptr->get_line_number());
+                    throw create_error("Lack of END IF",m_token.get_line_number());
                 }
             }
             else
             {
-                if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::END)
+                if(m_token.is_keyword(KEYWORD::END))
                 {
                     read_token();
-                    if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::IF)
+                    if(m_token.is_keyword(KEYWORD::IF))
                     {
                         read_token();
                         return selection_stmt_ptr;
                     }
                     else
                     {
-                        throw create_error("Lack of END IF",m_token_ptr->get_line_number());
+                        throw create_error("Lack of END IF",m_token.get_line_number());
                     }
                 }
                 else
                 {
-                    throw create_error("Lack of END IF",m_token_ptr->get_line_number());
+                    throw create_error("Lack of END IF",m_token.get_line_number());
                 }
             }
         }
         else
         {
-            throw create_error("Lack of THEN",m_token_ptr->get_line_number());
+            throw create_error("Lack of THEN",m_token.get_line_number());
         }
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::WHILE)
+    else if(m_token.is_keyword(KEYWORD::WHILE))
     {
-        WHILEIteratorStmt * while_stmt_ptr = new WHILEIteratorStmt();
+        WHILEIteratorStmt * while_stmt_ptr = m_arena_ptr->create<WHILEIteratorStmt>();
         read_token();
         while_stmt_ptr->set_condition(exp());
         read_token();
         std::vector<Stmt *> stmt_vector;
         stmts(stmt_vector);
-        for(auto it = stmt_vector.begin(); it != stmt_vector.end(); ++it)
-        {
-            while_stmt_ptr->add_stmt(*it);
-        }
-        if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::WEND)
+        while_stmt_ptr->set_stmts(m_arena_ptr->create_list(stmt_vector));
+        if(m_token.is_keyword(KEYWORD::WEND))
         {
             read_token();
             return while_stmt_ptr;
         }
         else
         {
-            throw create_error("Lack of WEND",m_token_ptr->get_line_number());
+            throw create_error("Lack of WEND",m_token.get_line_number());
         }
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::DO)
+    else if(m_token.is_keyword(KEYWORD::DO))
     {
-        DOIteratorStmt * do_stmt_ptr = new DOIteratorStmt();
+        DOIteratorStmt * do_stmt_ptr = m_arena_ptr->create<DOIteratorStmt>();
         read_token();
         read_token();
         std::vector<Stmt *> stmt_vector;
         stmts(stmt_vector);
-        for(auto it = stmt_vector.begin(); it != stmt_vector.end(); ++it)
-        {
-            do_stmt_ptr->add_stmt(*it);
-        }
-        if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::LOOP)
+        do_stmt_ptr->set_stmts(m_arena_ptr->create_list(stmt_vector));
+        if(m_token.is_keyword(KEYWORD::LOOP))
         {
             read_token();
-            if(m_token_ptr->get_token_type() == TOKEN::KEYWORD_TOKEN && dynamic_cast<KeywordToken *>(m_token_ptr)->get_keyword() == KEYWORD::UNTIL)
+            if(m_token.is_keyword(KEYWORD::UNTIL))
             {
                 read_token();
                 do_stmt_ptr->set_condition(exp());
@@ -256,35 +311,30 @@ Stmt * SyntaxAnalyer::stmt()throw (std::string)
             }
             else
             {
-                throw create_error("Lack of LOOP UNTIL",m_token_ptr->get_line_number());
+                throw create_error("Lack of LOOP UNTIL",m_token.get_line_number());
             }
         }
         else
         {
-            throw create_error("Lack of LOOP UNTIL",m_token_ptr->get_line_number());
+            throw create_error("Lack of LOOP UNTIL",m_token.get_line_number());
         }
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::NEW_LINE)
-    {
-        read_token();
-        return stmt();
-    }
     else
     {
         return nullptr;
     }
 }
 
-std::string * SyntaxAnalyer::prompt()throw (std::string)
+const char * SyntaxAnalyer::prompt()
 {
-    if(m_token_ptr->get_token_type() == TOKEN::STRING_TOKEN)
+    if(m_token.get_token_type() == TOKEN::STRING_TOKEN)
     {
 
-        std::string * str = new std::string(dynamic_cast<StringToken *>(m_token_ptr)->get_string());
+        const char * str = create_text(m_token);
         read_token();
-        if(!(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::SEMICOLON))
+        if(!(m_token.is_delimiter(DELIMITER::SEMICOLON)))
         {
-            throw create_error("Lack of ;",m_token_ptr->get_line_number());
+            throw create_error("Lack of ;",m_token.get_line_number());
         }
         read_token();
         return str;
@@ -295,167 +345,163 @@ std::string * SyntaxAnalyer::prompt()throw (std::string)
     }
 }
 
-void SyntaxAnalyer::ids(std::vector<VariableExpression *> & vars_vector)throw(std::string)
+void SyntaxAnalyer::ids(std::vector<VariableExpression *> & vars_vector)
 {
-    if(m_token_ptr->get_token_type() == TOKEN::IDENTIFIER_TOKEN)
+    if(m_token.get_token_type() == TOKEN::IDENTIFIER_TOKEN)
     {
-        VariableExpression * var_exp_ptr = new VariableExpression();
-        var_exp_ptr->set_line_number(m_token_ptr->get_line_number());
-        var_exp_ptr->set_variable_name(dynamic_cast<IdentifierToken *>(m_token_ptr)->get_identifier());
+        VariableExpression * var_exp_ptr = m_arena_ptr->create<VariableExpression>();
+        var_exp_ptr->set_line_number(m_token.get_line_number());
+        var_exp_ptr->set_variable_name(create_text(m_token));
         vars_vector.push_back(var_exp_ptr);
         read_token();
-        id_Tail(vars_vector);
     }
     else
     {
-        throw create_error("Lack of variable",m_token_ptr->get_line_number());
+        throw create_error("Lack of variable",m_token.get_line_number());
     }
-}
-
-void SyntaxAnalyer::id_Tail(std::vector<VariableExpression *> & vars_vector)throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::COMMA)
+    while(m_token.is_delimiter(DELIMITER::COMMA))
     {
         read_token();
-        if(m_token_ptr->get_token_type() == TOKEN::IDENTIFIER_TOKEN)
+        if(m_token.get_token_type() == TOKEN::IDENTIFIER_TOKEN)
         {
-            VariableExpression * var_exp_ptr = new VariableExpression();
-            var_exp_ptr->set_line_number(m_token_ptr->get_line_number());
-            var_exp_ptr->set_variable_name(dynamic_cast<IdentifierToken *>(m_token_ptr)->get_identifier());
+            VariableExpression * var_exp_ptr = m_arena_ptr->create<VariableExpression>();
+            var_exp_ptr->set_line_number(m_token.get_line_number());
+            var_exp_ptr->set_variable_name(create_text(m_token));
             vars_vector.push_back(var_exp_ptr);
             read_token();
-            id_Tail(vars_vector);
         }
         else
         {
-            throw create_error("Lack of ,",m_token_ptr->get_line_number());
+            throw create_error("Lack of ,",m_token.get_line_number());
         }
     }
 }
 
-Expression * SyntaxAnalyer::exp()throw(std::string)
+Expression * SyntaxAnalyer::exp()
 {
-    Expression * or_exp_ptr = or_exp();
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::AND)
+    //Operator precedence parsing over explicit stacks, the native stack only grows with parentheses
+    std::size_t operand_base = m_operand_stack.size();
+    std::size_t operator_base = m_operator_stack.size();
+    m_operand_stack.push_back(unary_exp());
+    while(m_token.get_token_type() == TOKEN::OPERATOR_TOKEN && binary_operator_precedence(m_token.get_operator()) != 0)
     {
-        BinaryExpression * binary_exp = new BinaryExpression();
-        binary_exp->set_left_expression(or_exp_ptr);
-        binary_exp->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
+        OPERATOR op = m_token.get_operator();
+        while(m_operator_stack.size() > operator_base && binds_before(m_operator_stack.back(),op))
+        {
+            reduce_binary_exp();
+        }
+        m_operator_stack.push_back(op);
         read_token();
-        binary_exp->set_right_expression(or_exp());
-        return binary_exp;
+        m_operand_stack.push_back(unary_exp());
     }
-    else
+    while(m_operator_stack.size() > operator_base)
     {
-        return or_exp_ptr;
+        reduce_binary_exp();
     }
+    Expression * exp_ptr = m_operand_stack.back();
+    m_operand_stack.resize(operand_base);
+    return exp_ptr;
+}
+
+void SyntaxAnalyer::reduce_binary_exp()
+{
+    OPERATOR op = m_operator_stack.back();
+    m_operator_stack.pop_back();
+    Expression * right_exp_ptr = m_operand_stack.back();
+    m_operand_stack.pop_back();
+    m_operand_stack.back() = create_binary_expression(*m_arena_ptr,op,m_operand_stack.back(),right_exp_ptr);
 }
 
-Expression * SyntaxAnalyer::primary_exp()throw(std::string)
+Expression * SyntaxAnalyer::primary_exp()
 {
-    if(m_token_ptr->get_token_type() == TOKEN::IDENTIFIER_TOKEN)
+    if(m_token.get_token_type() == TOKEN::IDENTIFIER_TOKEN)
     {
-        IdentifierToken id_token(m_token_ptr->get_line_number(),dynamic_cast<IdentifierToken *>(m_token_ptr)->get_identifier());
-        read_token();
-        if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::LEFT_PARENTHESIS)
+        if(peek_token().is_delimiter(DELIMITER::LEFT_PARENTHESIS))
         {
-            CallExpression * call_exp_ptr = new CallExpression();
-            call_exp_ptr->set_line_number(id_token.get_line_number());
-            call_exp_ptr->set_function_name(id_token.get_identifier());
+            CallExpression * call_exp_ptr = m_arena_ptr->create<CallExpression>();
+            call_exp_ptr->set_line_number(m_token.get_line_number());
+            call_exp_ptr->set_function_name(create_text(m_token));
+            read_token();
             read_token();
             std::vector<Expression *> arg_vector;
             param(arg_vector);
-            for(auto it = arg_vector.begin(); it!=arg_vector.end(); ++it)
-            {
-                call_exp_ptr->add_expression(*it);
-            }
+            call_exp_ptr->set_expressions(m_arena_ptr->create_list(arg_vector));
+            bind_function(call_exp_ptr);
             return call_exp_ptr;
         }
         else
         {
-            VariableExpression * var_exp_ptr = new VariableExpression();
-            var_exp_ptr->set_line_number(id_token.get_line_number());
-            var_exp_ptr->set_variable_name(id_token.get_identifier());
+            VariableExpression * var_exp_ptr = m_arena_ptr->create<VariableExpression>();
+            var_exp_ptr->set_line_number(m_token.get_line_number());
+            var_exp_ptr->set_variable_name(create_text(m_token));
+            read_token();
             return var_exp_ptr;
         }
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::DECIMAL_TOKEN)
+    else if(m_token.get_token_type() == TOKEN::DECIMAL_TOKEN)
     {
-        DecimalExpression * decimal_exp_ptr = new DecimalExpression();
-        decimal_exp_ptr->set_decimal(dynamic_cast<DecimalToken *>(m_token_ptr)->get_decimal());
+        DecimalExpression * decimal_exp_ptr = m_arena_ptr->create<DecimalExpression>();
+        decimal_exp_ptr->set_decimal(m_token.get_decimal());
         read_token();
         return decimal_exp_ptr;
     }
-    else if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::LEFT_PARENTHESIS)
+    else if(m_token.is_delimiter(DELIMITER::LEFT_PARENTHESIS))
     {
         read_token();
         Expression * exp_ptr = exp();
-        if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::RIGHT_PARENTHESIS)
+        if(m_token.is_delimiter(DELIMITER::RIGHT_PARENTHESIS))
         {
             read_token();
             return exp_ptr;
         }
         else
         {
-            throw create_error("Lack of )",m_token_ptr->get_line_number());
+            throw create_error("Lack of )",m_token.get_line_number());
         }
     }
     else
     {
-        throw create_error("Not id, id(), (expression) or decimal",m_token_ptr->get_line_number());
+        throw create_error("Not id, id(), (expression) or decimal",m_token.get_line_number());
     }
 }
 
-void SyntaxAnalyer::param(std::vector<Expression *> & exp_vector)throw(std::string)
+void SyntaxAnalyer::param(std::vector<Expression *> & exp_vector)
 {
-    if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::RIGHT_PARENTHESIS)
+    if(m_token.is_delimiter(DELIMITER::RIGHT_PARENTHESIS))
     {
         read_token();
     }
     else
     {
-        std::vector<Expression *> n_exp_vector;
-        args(n_exp_vector);
-        if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::RIGHT_PARENTHESIS)
+        args(exp_vector);
+        if(m_token.is_delimiter(DELIMITER::RIGHT_PARENTHESIS))
         {
             read_token();
-            for(auto it = n_exp_vector.begin(); it!=n_exp_vector.end(); ++it)
-            {
-                exp_vector.push_back(*it);
-            }
         }
         else
         {
-            throw create_error("Lack of )",m_token_ptr->get_line_number());
+            throw create_error("Lack of )",m_token.get_line_number());
         }
     }
 }
 
-void SyntaxAnalyer::args(std::vector<Expression *> & exp_vector)throw(std::string)
+void SyntaxAnalyer::args(std::vector<Expression *> & exp_vector)
 {
     exp_vector.push_back(exp());
-    arg_tail(exp_vector);
-}
-
-void SyntaxAnalyer::arg_tail(std::vector<Expression *> & exp_vector)throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::DELIMITER_TOKEN && dynamic_cast<DelimiterToken *>(m_token_ptr)->get_delimiter() == DELIMITER::COMMA)
+    while(m_token.is_delimiter(DELIMITER::COMMA))
     {
         read_token();
         exp_vector.push_back(exp());
-        arg_tail(exp_vector);
     }
 }
 
-Expression * SyntaxAnalyer::unary_exp()throw(std::string)
+Expression * SyntaxAnalyer::unary_exp()
 {
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && (dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::PLUS || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::SUBSTRACT || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::NOT))
+    if(m_token.get_token_type() == TOKEN::OPERATOR_TOKEN && (m_token.get_operator() == OPERATOR::PLUS || m_token.get_operator() == OPERATOR::SUBSTRACT || m_token.get_operator() == OPERATOR::NOT))
     {
-        UnaryExpression * unary_exp_ptr = new UnaryExpression();
-        unary_exp_ptr->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
+        OPERATOR op = m_token.get_operator();
         read_token();
-        unary_exp_ptr->set_expression(primary_exp());
-        return unary_exp_ptr;
+        return create_unary_expression(*m_arena_ptr,op,primary_exp());
     }
     else
     {
@@ -463,313 +509,15 @@ Expression * SyntaxAnalyer::unary_exp()throw(std::string)
     }
 }
 
-Expression * SyntaxAnalyer::power_exp()throw(std::string)
-{
-    Expression * unary_exp_ptr = unary_exp();
-    TailExpression * power_exp_ptr = power_exp_tail();
-    if(power_exp_ptr != nullptr)
-    {
-        BinaryExpression * binary_exp = new BinaryExpression();
-        binary_exp->set_left_expression(unary_exp_ptr);
-        binary_exp->set_operator(power_exp_ptr->get_operator());
-        binary_exp->set_right_expression(power_exp_ptr->get_expression());
-        delete power_exp_ptr;
-        return binary_exp;
-    }
-    else
-    {
-        return unary_exp_ptr;
-    }
-}
-
-TailExpression * SyntaxAnalyer::power_exp_tail()throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::POWER)
-    {
-        TailExpression * tail_exp_ptr = new TailExpression();
-        tail_exp_ptr->set_operator(OPERATOR::POWER);
-        read_token();
-        Expression * unary_exp_ptr = unary_exp();
-        TailExpression * power_exp_tail_ptr = power_exp_tail();
-        if(power_exp_tail_ptr != nullptr)
-        {
-            BinaryExpression * binary_exp_ptr = new BinaryExpression();
-            binary_exp_ptr->set_left_expression(unary_exp_ptr);
-            binary_exp_ptr->set_operator(power_exp_tail_ptr->get_operator());
-            binary_exp_ptr->set_right_expression(power_exp_tail_ptr->get_expression());
-            tail_exp_ptr->set_expression(binary_exp_ptr);
-            delete power_exp_tail_ptr;
-            return tail_exp_ptr;
-        }
-        else
-        {
-            tail_exp_ptr->set_expression(unary_exp_ptr);
-            return tail_exp_ptr;
-        }
-    }
-    else
-    {
-        return nullptr;
-    }
-}
-
-Expression * SyntaxAnalyer::mult_exp()throw(std::string)
-{
-    Expression * power_exp_ptr = power_exp();
-    TailExpression * mult_exp_tail_ptr = mult_exp_tail();
-    if(mult_exp_tail_ptr != nullptr)
-    {
-        BinaryExpression * binary_exp_ptr = new BinaryExpression();
-        binary_exp_ptr->set_left_expression(power_exp_ptr);
-        binary_exp_ptr->set_operator(mult_exp_tail_ptr->get_operator());
-        binary_exp_ptr->set_right_expression(mult_exp_tail_ptr->get_expression());
-        delete mult_exp_tail_ptr;
-        return binary_exp_ptr;
-    }
-    else
-    {
-        return power_exp_ptr;
-    }
-}
-
-TailExpression * SyntaxAnalyer::mult_exp_tail()throw(std::string)
+//Unknown functions stay unbound and fail when they are called, so a call that never runs is no error
+void SyntaxAnalyer::bind_function(CallExpression * call_expression)
 {
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && (dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::MULTIPLY || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::DIVIDE || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::DIVIDE_EXACTLY))
+    const Function * function = m_function_table.find_function(call_expression->get_function_name());
+    if(function != nullptr && function->arity != call_expression->get_expressions().size())
     {
-        TailExpression * tail_exp_ptr = new TailExpression();
-        tail_exp_ptr->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
-        read_token();
-        Expression * power_exp_ptr = power_exp();
-        //
-        TailExpression * mult_exp_tail_ptr = mult_exp_tail();
-        if(mult_exp_tail_ptr != nullptr)
-        {
-            BinaryExpression * binary_exp_ptr = new BinaryExpression();
-            binary_exp_ptr->set_left_expression(power_exp_ptr);
-            binary_exp_ptr->set_operator(mult_exp_tail_ptr->get_operator());
-            binary_exp_ptr->set_right_expression(mult_exp_tail_ptr->get_expression());
-            tail_exp_ptr->set_expression(binary_exp_ptr);
-            delete mult_exp_tail_ptr;
-            return tail_exp_ptr;
-        }
-        else
-        {
-            tail_exp_ptr->set_expression(power_exp_ptr);
-            return tail_exp_ptr;
-        }
-    }
-    else
-    {
-        return nullptr;
-    }
-}
-
-Expression * SyntaxAnalyer::mod_exp()throw(std::string)
-{
-    Expression * mult_exp_ptr = mult_exp();
-    TailExpression * mod_exp_tail_ptr = mod_exp_tail();
-    if(mod_exp_tail_ptr != nullptr)
-    {
-        BinaryExpression * binary_exp_ptr = new BinaryExpression();
-        binary_exp_ptr->set_left_expression(mult_exp_ptr);
-        binary_exp_ptr->set_operator(mod_exp_tail_ptr->get_operator());
-        binary_exp_ptr->set_right_expression(mod_exp_tail_ptr->get_expression());
-        delete mod_exp_tail_ptr;
-        return binary_exp_ptr;
-    }
-    else
-    {
-        return mult_exp_ptr;
-    }
-}
-
-TailExpression * SyntaxAnalyer::mod_exp_tail()throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::MOD)
-    {
-        TailExpression * tail_exp_ptr = new TailExpression();
-        tail_exp_ptr->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
-        read_token();
-        Expression * mult_exp_ptr = mult_exp();
-
-        TailExpression * mod_exp_tail_ptr = mod_exp_tail();
-        if(mod_exp_tail_ptr != nullptr)
-        {
-            BinaryExpression * binary_exp_ptr = new BinaryExpression();
-            binary_exp_ptr->set_left_expression(mult_exp_ptr);
-            binary_exp_ptr->set_operator(mod_exp_tail_ptr->get_operator());
-            binary_exp_ptr->set_right_expression(mod_exp_tail_ptr->get_expression());
-            tail_exp_ptr->set_expression(binary_exp_ptr);
-            delete mod_exp_tail_ptr;
-            return tail_exp_ptr;
-        }
-        else
-        {
-            tail_exp_ptr->set_expression(mult_exp_ptr);
-            return tail_exp_ptr;
-        }
-    }
-    else
-    {
-        return nullptr;
-    }
-}
-
-Expression * SyntaxAnalyer::add_exp()throw(std::string)
-{
-    Expression * mod_exp_ptr = mod_exp();
-    TailExpression * add_exp_tail_ptr = add_exp_tail();
-    if(add_exp_tail_ptr != nullptr)
-    {
-        BinaryExpression * binary_exp_ptr = new BinaryExpression();
-        binary_exp_ptr->set_left_expression(mod_exp_ptr);
-        binary_exp_ptr->set_operator(add_exp_tail_ptr->get_operator());
-        binary_exp_ptr->set_right_expression(add_exp_tail_ptr->get_expression());
-        delete add_exp_tail_ptr;
-        return binary_exp_ptr;
-    }
-    else
-    {
-        return mod_exp_ptr;
-    }
-}
-
-TailExpression * SyntaxAnalyer::add_exp_tail()throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && (dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::PLUS || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::SUBSTRACT))
-    {
-        TailExpression * tail_exp_ptr = new TailExpression();
-        tail_exp_ptr->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
-        read_token();
-        Expression * mod_exp_ptr = mod_exp();
-
-        TailExpression * add_exp_tail_ptr = add_exp_tail();
-        if(add_exp_tail_ptr != nullptr)
-        {
-            BinaryExpression * binary_exp_ptr = new BinaryExpression();
-            binary_exp_ptr->set_left_expression(mod_exp_ptr);
-            binary_exp_ptr->set_operator(add_exp_tail_ptr->get_operator());
-            binary_exp_ptr->set_right_expression(add_exp_tail_ptr->get_expression());
-            tail_exp_ptr->set_expression(binary_exp_ptr);
-            delete add_exp_tail_ptr;
-            return tail_exp_ptr;
-        }
-        else
-        {
-            tail_exp_ptr->set_expression(mod_exp_ptr);
-            return tail_exp_ptr;
-        }
-    }
-    else
-    {
-        return nullptr;
-    }
-}
-
-Expression * SyntaxAnalyer::relationship_exp()throw(std::string)
-{
-    Expression * add_exp_ptr = add_exp();
-    TailExpression * relationship_exp_tail_ptr = relationship_exp_tail();
-    if(relationship_exp_tail_ptr != nullptr)
-    {
-        BinaryExpression * binary_exp_ptr = new BinaryExpression();
-        binary_exp_ptr->set_left_expression(add_exp_ptr);
-        binary_exp_ptr->set_operator(relationship_exp_tail_ptr->get_operator());
-        binary_exp_ptr->set_right_expression(relationship_exp_tail_ptr->get_expression());
-        delete relationship_exp_tail_ptr;
-        return binary_exp_ptr;
-    }
-    else
-    {
-        return add_exp_ptr;
-    }
-}
-
-TailExpression * SyntaxAnalyer::relationship_exp_tail()throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && (dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::EQUAL
-            || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::GREATER_THEN
-            || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::LESS_THEN
-            || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::NOT_EQUAL
-            || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::LESS_THEN_OR_EQUAL
-            || dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::GREATER_THEN_OR_EQUAL))
-    {
-        TailExpression * tail_exp_ptr = new TailExpression();
-        tail_exp_ptr->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
-        read_token();
-        Expression * add_exp_ptr = add_exp();
-
-        TailExpression * relationship_exp_tail_ptr = relationship_exp_tail();
-        if(relationship_exp_tail_ptr != nullptr)
-        {
-            BinaryExpression * binary_exp_ptr = new BinaryExpression();
-            binary_exp_ptr->set_left_expression(add_exp_ptr);
-            binary_exp_ptr->set_operator(relationship_exp_tail_ptr->get_operator());
-            binary_exp_ptr->set_right_expression(relationship_exp_tail_ptr->get_expression());
-            tail_exp_ptr->set_expression(binary_exp_ptr);
-            delete relationship_exp_tail_ptr;
-            return tail_exp_ptr;
-        }
-        else
-        {
-            tail_exp_ptr->set_expression(add_exp_ptr);
-            return tail_exp_ptr;
-        }
-    }
-    else
-    {
-        return nullptr;
+        throw create_error("The \"" + call_expression->get_function_name() + "\" function takes " + std::to_string(function->arity) + (function->arity == 1 ? " argument" : " arguments"),call_expression->get_line_number());
     }
+    call_expression->set_function(function);
 }
-
-Expression * SyntaxAnalyer::or_exp()throw(std::string)
-{
-    Expression * relationship_exp_ptr = relationship_exp();
-    TailExpression * or_exp_tail_ptr = or_exp_tail();
-    if(or_exp_tail_ptr != nullptr)
-    {
-        BinaryExpression * binary_exp_ptr = new BinaryExpression();
-        binary_exp_ptr->set_left_expression(relationship_exp_ptr);
-        binary_exp_ptr->set_operator(or_exp_tail_ptr->get_operator());
-        binary_exp_ptr->set_right_expression(or_exp_tail_ptr->get_expression());
-        delete or_exp_tail_ptr;
-        return binary_exp_ptr;
-    }
-    else
-    {
-        return relationship_exp_ptr;
-    }
-}
-
-TailExpression * SyntaxAnalyer::or_exp_tail()throw(std::string)
-{
-    if(m_token_ptr->get_token_type() == TOKEN::OPERATOR_TOKEN && dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator() == OPERATOR::OR)
-    {
-        TailExpression * tail_exp_ptr = new TailExpression();
-        tail_exp_ptr->set_operator(dynamic_cast<OperatorToken *>(m_token_ptr)->get_operator());
-        read_token();
-        Expression * relationship_exp_ptr = relationship_exp();
-
-        TailExpression * or_exp_tail_ptr = or_exp_tail();
-        if(or_exp_tail_ptr != nullptr)
-        {
-            BinaryExpression * binary_exp_ptr = new BinaryExpression();
-            binary_exp_ptr->set_left_expression(relationship_exp_ptr);
-            binary_exp_ptr->set_operator(or_exp_tail_ptr->get_operator());
-            binary_exp_ptr->set_right_expression(or_exp_tail_ptr->get_expression());
-            tail_exp_ptr->set_expression(binary_exp_ptr);
-            delete or_exp_tail_ptr;
-            return tail_exp_ptr;
-        }
-        else
-        {
-            tail_exp_ptr->set_expression(relationship_exp_ptr);
-            return tail_exp_ptr;
-        }
-    }
-    else
-    {
-        return nullptr;
-    }
 }
 }
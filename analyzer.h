@@ -6,50 +6,51 @@
 #include <vector>
 namespace SBASIC
 {
+inline namespace SBASIC_NUMERIC
+{
 class SyntaxAnalyer
 {
 private:
+    static const unsigned int LOOKAHEAD = 2;
     TokenReader & m_token_reader;
-    Token * m_token_ptr;
+    const FunctionTable & m_function_table;
+    Token m_token;
+    Token m_lookahead_tokens[LOOKAHEAD];
+    unsigned int m_lookahead_begin;
+    unsigned int m_lookahead_count;
+    Arena * m_arena_ptr;
+    //Pending operands and operators of the expressions being parsed
+    std::vector<Expression *> m_operand_stack;
+    std::vector<OPERATOR> m_operator_stack;
     void read_token();
-    void stmts(std::vector<Stmt *> & stmt_vector)throw (std::string);
-    void exps(std::vector<Expression *> & exp_vector)throw(std::string);
-    void exp_tail(std::vector<Expression *> & exp_vector)throw(std::string);
-    Stmt * stmt()throw(std::string);
-    std::string * prompt()throw (std::string);
-    void ids(std::vector<VariableExpression *> & vars_vector)throw(std::string);
-    void id_Tail(std::vector<VariableExpression *> & vars_vector)throw(std::string);
-    Expression * exp()throw(std::string);
-    Expression * primary_exp()throw(std::string);
-    void param(std::vector<Expression *> & exp_vector)throw(std::string);
-    void args(std::vector<Expression *> & exp_vector)throw(std::string);
-    void arg_tail(std::vector<Expression *> & exp_vector)throw(std::string);
-    Expression * unary_exp()throw(std::string);
-    Expression * power_exp()throw(std::string);
-    TailExpression * power_exp_tail()throw(std::string);
-    Expression * mult_exp()throw(std::string);
-    TailExpression * mult_exp_tail()throw(std::string);
-    Expression * mod_exp()throw(std::string);
-    TailExpression * mod_exp_tail()throw(std::string);
-    Expression * add_exp()throw(std::string);
-    TailExpression * add_exp_tail()throw(std::string);
-    Expression * relationship_exp()throw(std::string);
-    TailExpression * relationship_exp_tail()throw(std::string);
-    Expression * or_exp()throw(std::string);
-    TailExpression * or_exp_tail()throw(std::string);
+    const Token & peek_token(unsigned int n = 1);
+    const char * create_text(const Token & token);
+    void stmts(std::vector<Stmt *> & stmt_vector);
+    void exps(std::vector<Expression *> & exp_vector);
+    Stmt * stmt();
+    const char * prompt();
+    void ids(std::vector<VariableExpression *> & vars_vector);
+    Expression * exp();
+    Expression * primary_exp();
+    void param(std::vector<Expression *> & exp_vector);
+    void args(std::vector<Expression *> & exp_vector);
+    void reduce_binary_exp();
+    Expression * unary_exp();
+    void bind_function(CallExpression * call_expression);
     std::string create_error(const std::string & error,line_number ln)
     {
         return "Line: " + std::to_string(ln) + ", Error: " + error;
     }
 public:
-    SyntaxAnalyer(TokenReader & token_reader);
-    ~SyntaxAnalyer();
-    Program * analyer() throw(std::string);
+    //Calls are bound to the functions of the table as they are parsed
+    SyntaxAnalyer(TokenReader & token_reader,const FunctionTable & function_table);
+    Program * analyer();
     void delete_program(Program * program)
     {
         delete program;
     }
 };
 }
+}
 
 #endif // ANALYZER_H_INCLUDED
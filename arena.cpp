@@ -0,0 +1,52 @@
+#include "arena.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace SBASIC
+{
+Arena::~Arena()
+{
+    while(m_chunk_ptr != nullptr)
+    {
+        Chunk * previous_chunk_ptr = m_chunk_ptr->m_previous_chunk_ptr;
+        std::free(m_chunk_ptr);
+        m_chunk_ptr = previous_chunk_ptr;
+    }
+}
+
+void Arena::new_chunk(std::size_t size)
+{
+    //Chunks grow up to 1 MiB, so teardown frees a few blocks instead of every node
+    std::size_t chunk_size = m_next_chunk_size;
+    while(chunk_size < size + sizeof(Chunk))
+    {
+        chunk_size *= 2;
+    }
+    if(m_next_chunk_size < (std::size_t(1) << 20))
+    {
+        m_next_chunk_size *= 2;
+    }
+    Chunk * chunk_ptr = static_cast<Chunk *>(std::malloc(chunk_size));
+    if(chunk_ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    chunk_ptr->m_previous_chunk_ptr = m_chunk_ptr;
+    m_chunk_ptr = chunk_ptr;
+    m_current = reinterpret_cast<char *>(chunk_ptr) + sizeof(Chunk);
+    m_end = reinterpret_cast<char *>(chunk_ptr) + chunk_size;
+}
+
+const char * Arena::create_string(const std::string & str)
+{
+    return create_string(str.data(),str.size());
+}
+
+const char * Arena::create_string(const char * str,std::size_t length)
+{
+    char * ptr = static_cast<char *>(allocate(length + 1,1));
+    std::memcpy(ptr,str,length);
+    ptr[length] = '\0';
+    return ptr;
+}
+}
@@ -0,0 +1,98 @@
+#ifndef ARENA_H_INCLUDED
+#define ARENA_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <new>
+#include <utility>
+namespace SBASIC
+{
+//Node list, a fixed array living in an Arena
+template<typename T>
+class NodeList
+{
+private:
+    T * m_nodes;
+    std::size_t m_size;
+public:
+    NodeList() : m_nodes(nullptr), m_size(0) {}
+    NodeList(T * nodes,std::size_t size) : m_nodes(nodes), m_size(size) {}
+    T * begin() const
+    {
+        return m_nodes;
+    }
+    T * end() const
+    {
+        return m_nodes + m_size;
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+    T & operator[](std::size_t index) const
+    {
+        return m_nodes[index];
+    }
+};
+
+//Arena, a bump allocator releasing everything at once
+class Arena
+{
+private:
+    struct Chunk
+    {
+        Chunk * m_previous_chunk_ptr;
+    };
+    Chunk * m_chunk_ptr;
+    char * m_current;
+    char * m_end;
+    std::size_t m_next_chunk_size;
+    void new_chunk(std::size_t size);
+public:
+    Arena() : m_chunk_ptr(nullptr), m_current(nullptr), m_end(nullptr), m_next_chunk_size(4096) {}
+    Arena(const Arena &) = delete;
+    Arena & operator=(const Arena &) = delete;
+    ~Arena();
+    void * allocate(std::size_t size,std::size_t alignment)
+    {
+        std::size_t padding = (alignment - reinterpret_cast<std::size_t>(m_current) % alignment) % alignment;
+        if(m_current == nullptr || std::size_t(m_end - m_current) < size + padding)
+        {
+            new_chunk(size + alignment);
+            padding = (alignment - reinterpret_cast<std::size_t>(m_current) % alignment) % alignment;
+        }
+        void * ptr = m_current + padding;
+        m_current += padding + size;
+        return ptr;
+    }
+    //Objects created here are never destroyed, they must not own other memory
+    template<typename T,typename... Args>
+    T * create(Args &&... args)
+    {
+        return new(allocate(sizeof(T),alignof(T))) T(std::forward<Args>(args)...);
+    }
+    template<typename T>
+    NodeList<T> create_list(const std::vector<T> & nodes)
+    {
+        if(nodes.empty())
+        {
+            return NodeList<T>();
+        }
+        T * ptr = static_cast<T *>(allocate(sizeof(T) * nodes.size(),alignof(T)));
+        for(std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            new(ptr + i) T(nodes[i]);
+        }
+        return NodeList<T>(ptr,nodes.size());
+    }
+    const char * create_string(const std::string & str);
+    const char * create_string(const char * str,std::size_t length);
+};
+}
+
+#endif // ARENA_H_INCLUDED
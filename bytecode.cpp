@@ -0,0 +1,471 @@
+#include "bytecode.h"
+#include <cmath>
+#include <vector>
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+OPCODE binary_opcode(OPERATOR op)
+{
+    switch(op)
+    {
+    case OPERATOR::PLUS:
+        return OPCODE::PLUS;
+    case OPERATOR::SUBSTRACT:
+        return OPCODE::SUBSTRACT;
+    case OPERATOR::MULTIPLY:
+        return OPCODE::MULTIPLY;
+    case OPERATOR::DIVIDE:
+        return OPCODE::DIVIDE;
+    case OPERATOR::DIVIDE_EXACTLY:
+        return OPCODE::DIVIDE_EXACTLY;
+    case OPERATOR::POWER:
+        return OPCODE::POWER;
+    case OPERATOR::MOD:
+        return OPCODE::MOD;
+    case OPERATOR::EQUAL:
+        return OPCODE::EQUAL;
+    case OPERATOR::GREATER_THEN:
+        return OPCODE::GREATER_THEN;
+    case OPERATOR::LESS_THEN:
+        return OPCODE::LESS_THEN;
+    case OPERATOR::NOT_EQUAL:
+        return OPCODE::NOT_EQUAL;
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+        return OPCODE::GREATER_THEN_OR_EQUAL;
+    default:
+        return OPCODE::LESS_THEN_OR_EQUAL;
+    }
+}
+
+Bytecode * BytecodeCompiler::compile(const Program * program)
+{
+    m_bytecode = new Bytecode();
+    m_constants.clear();
+    m_defined_variables.assign(program->get_variable_count(),false);
+    m_scope_variables.clear();
+    m_scopes.clear();
+
+    //Registers: variable slots, then constants, then temporaries
+    collect_stmts(program->get_stmts());
+    register_index variable_count = register_index(program->get_variable_count());
+    for(auto it = m_constants.begin(); it != m_constants.end(); ++it)
+    {
+        it->second += variable_count;
+    }
+    m_bytecode->m_constant_base = variable_count;
+    m_temporary_base = variable_count + register_index(m_bytecode->m_constants.size());
+    m_next_temporary = m_temporary_base;
+    m_bytecode->m_register_count = m_temporary_base;
+
+    stmts(program->get_stmts());
+    emit(OPCODE::HALT);
+    Bytecode * bytecode = m_bytecode;
+    m_bytecode = nullptr;
+    return bytecode;
+}
+
+void BytecodeCompiler::collect_stmts(const NodeList<Stmt *> & stmts)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        const Stmt * stmt_ptr = *it;
+        switch(stmt_ptr->get_stmt_type())
+        {
+        case STMT::PRINT_STMT:
+        {
+            const NodeList<Expression *> & exps = static_cast<const PrintStmt *>(stmt_ptr)->get_expressions();
+            for(auto exp_it = exps.begin(); exp_it != exps.end(); ++exp_it)
+            {
+                collect_expression(*exp_it);
+            }
+            break;
+        }
+        case STMT::INPUT_STMT:
+            break;
+        case STMT::ASSIGNMENT_STMT:
+            collect_expression(static_cast<const AssignmentStmt *>(stmt_ptr)->get_expression());
+            break;
+        case STMT::DO_ITERATOR_STMT:
+            collect_stmts(static_cast<const DOIteratorStmt *>(stmt_ptr)->get_stmts());
+            collect_expression(static_cast<const DOIteratorStmt *>(stmt_ptr)->get_condition());
+            break;
+        case STMT::SELECTION_STMT:
+            collect_expression(static_cast<const SelectionStmt *>(stmt_ptr)->get_condition());
+            collect_stmts(static_cast<const SelectionStmt *>(stmt_ptr)->get_true_stmts());
+            collect_stmts(static_cast<const SelectionStmt *>(stmt_ptr)->get_false_stmts());
+            break;
+        case STMT::WHILE_ITERATOR_STMT:
+            collect_expression(static_cast<const WHILEIteratorStmt *>(stmt_ptr)->get_condition());
+            collect_stmts(static_cast<const WHILEIteratorStmt *>(stmt_ptr)->get_stmts());
+            break;
+        case STMT::BLOCK_STMT:
+            collect_stmts(static_cast<const BlockStmt *>(stmt_ptr)->get_stmts());
+            break;
+        }
+    }
+}
+
+void BytecodeCompiler::collect_expression(const Expression * expression)
+{
+    //Right operands in a loop, see MAX_NESTED_OPERATORS
+    while(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        collect_expression(static_cast<const BinaryExpression *>(expression)->get_left_expression());
+        expression = static_cast<const BinaryExpression *>(expression)->get_right_expression();
+    }
+    switch(expression->get_expression_type())
+    {
+    case EXPRESSION::UNARY_EXPRESSION:
+        collect_expression(static_cast<const UnaryExpression *>(expression)->get_expression());
+        break;
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    case EXPRESSION::BINARY_EXPRESSION:
+        break;
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        const NodeList<Expression *> & exps = static_cast<const CallExpression *>(expression)->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            collect_expression(*it);
+        }
+        break;
+    }
+    case EXPRESSION::DECIMAL_EXPRESSION:
+    {
+        sbasic_decimal_type decimal = static_cast<const DecimalExpression *>(expression)->get_decimal();
+        //NaN never compares equal, so each one gets its own register
+        if(std::isnan(decimal) || !m_constants.count(std::make_pair(bool(std::signbit(decimal)),decimal)))
+        {
+            register_index index = register_index(m_bytecode->m_constants.size());
+            m_bytecode->m_constants.push_back(decimal);
+            if(!std::isnan(decimal))
+            {
+                m_constants[std::make_pair(bool(std::signbit(decimal)),decimal)] = index;
+            }
+        }
+        break;
+    }
+    }
+}
+
+register_index BytecodeCompiler::constant_register(sbasic_decimal_type decimal)
+{
+    if(std::isnan(decimal))
+    {
+        //Any NaN register prints and compares the same way
+        for(std::size_t i = 0; i < m_bytecode->m_constants.size(); ++i)
+        {
+            if(std::isnan(m_bytecode->m_constants[i]) && std::signbit(m_bytecode->m_constants[i]) == std::signbit(decimal))
+            {
+                return m_bytecode->m_constant_base + register_index(i);
+            }
+        }
+    }
+    return m_constants[std::make_pair(bool(std::signbit(decimal)),decimal)];
+}
+
+register_index BytecodeCompiler::string_index(const std::string & str)
+{
+    m_bytecode->m_strings.push_back(str);
+    return register_index(m_bytecode->m_strings.size() - 1);
+}
+
+register_index BytecodeCompiler::new_temporary()
+{
+    register_index temporary = m_next_temporary++;
+    if(m_next_temporary > m_bytecode->m_register_count)
+    {
+        m_bytecode->m_register_count = m_next_temporary;
+    }
+    return temporary;
+}
+
+bool BytecodeCompiler::is_defined(variable_slot slot) const
+{
+    return m_defined_variables[slot];
+}
+
+void BytecodeCompiler::define(variable_slot slot)
+{
+    //Assignment updates the variable of an outer block, otherwise creates it in the current block
+    if(!m_defined_variables[slot])
+    {
+        m_defined_variables[slot] = true;
+        m_scope_variables.push_back(slot);
+    }
+}
+
+void BytecodeCompiler::enter_scope()
+{
+    m_scopes.push_back(m_scope_variables.size());
+}
+
+void BytecodeCompiler::leave_scope()
+{
+    //Variables created inside the block disappear with it
+    for(std::size_t i = m_scopes.back(); i < m_scope_variables.size(); ++i)
+    {
+        m_defined_variables[m_scope_variables[i]] = false;
+    }
+    m_scope_variables.resize(m_scopes.back());
+    m_scopes.pop_back();
+}
+
+std::size_t BytecodeCompiler::emit(OPCODE opcode,register_index a,register_index b,register_index c)
+{
+    Instruction instruction = {opcode,a,b,c};
+    m_bytecode->m_instructions.push_back(instruction);
+    return m_bytecode->m_instructions.size() - 1;
+}
+
+void BytecodeCompiler::patch(std::size_t instruction,register_index target)
+{
+    Instruction & ins = m_bytecode->m_instructions[instruction];
+    if(ins.opcode == OPCODE::JUMP)
+    {
+        ins.a = target;
+    }
+    else
+    {
+        ins.b = target;
+    }
+}
+
+void BytecodeCompiler::stmts(const NodeList<Stmt *> & stmts)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        stmt(*it);
+        m_next_temporary = m_temporary_base;
+    }
+}
+
+void BytecodeCompiler::stmt(const Stmt * stmt_ptr)
+{
+    switch(stmt_ptr->get_stmt_type())
+    {
+    case STMT::PRINT_STMT:
+    {
+        const PrintStmt * print_stmt_ptr = static_cast<const PrintStmt *>(stmt_ptr);
+        if(print_stmt_ptr->has_prompt())
+        {
+            emit(OPCODE::PRINT_STRING,string_index(print_stmt_ptr->get_prompt()));
+        }
+        const NodeList<Expression *> & exps = print_stmt_ptr->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            register_index mark = m_next_temporary;
+            emit(OPCODE::PRINT,expression(*it));
+            m_next_temporary = mark;
+        }
+        break;
+    }
+    case STMT::INPUT_STMT:
+    {
+        const InputStmt * input_stmt_ptr = static_cast<const InputStmt *>(stmt_ptr);
+        emit(OPCODE::INPUT_PROMPT,string_index(input_stmt_ptr->has_prompt() ? input_stmt_ptr->get_prompt() : ""));
+        const NodeList<VariableExpression *> & exps = input_stmt_ptr->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            emit(OPCODE::INPUT,(**it).get_slot());
+            define((**it).get_slot());
+        }
+        break;
+    }
+    case STMT::ASSIGNMENT_STMT:
+    {
+        const AssignmentStmt * assignment_stmt_ptr = static_cast<const AssignmentStmt *>(stmt_ptr);
+        variable_slot slot = assignment_stmt_ptr->get_variable_expression()->get_slot();
+        expression_to(assignment_stmt_ptr->get_expression(),slot);
+        define(slot);
+        break;
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        const DOIteratorStmt * do_stmt_ptr = static_cast<const DOIteratorStmt *>(stmt_ptr);
+        register_index body = here();
+        enter_scope();
+        stmts(do_stmt_ptr->get_stmts());
+        leave_scope();
+        emit(OPCODE::JUMP_IF_FALSE,expression(do_stmt_ptr->get_condition()),body);
+        break;
+    }
+    case STMT::SELECTION_STMT:
+    {
+        const SelectionStmt * selection_stmt_ptr = static_cast<const SelectionStmt *>(stmt_ptr);
+        std::size_t jump_false = emit(OPCODE::JUMP_IF_NOT_TRUE,expression(selection_stmt_ptr->get_condition()));
+        m_next_temporary = m_temporary_base;
+        enter_scope();
+        stmts(selection_stmt_ptr->get_true_stmts());
+        leave_scope();
+        if(selection_stmt_ptr->get_false_stmts().empty())
+        {
+            patch(jump_false,here());
+        }
+        else
+        {
+            std::size_t jump_end = emit(OPCODE::JUMP);
+            patch(jump_false,here());
+            enter_scope();
+            stmts(selection_stmt_ptr->get_false_stmts());
+            leave_scope();
+            patch(jump_end,here());
+        }
+        break;
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        //Condition is placed after the body, so each iteration takes a single branch
+        const WHILEIteratorStmt * while_stmt_ptr = static_cast<const WHILEIteratorStmt *>(stmt_ptr);
+        std::size_t jump_condition = emit(OPCODE::JUMP);
+        register_index body = here();
+        enter_scope();
+        stmts(while_stmt_ptr->get_stmts());
+        leave_scope();
+        patch(jump_condition,here());
+        emit(OPCODE::JUMP_IF_TRUE,expression(while_stmt_ptr->get_condition()),body);
+        break;
+    }
+    case STMT::BLOCK_STMT:
+        enter_scope();
+        stmts(static_cast<const BlockStmt *>(stmt_ptr)->get_stmts());
+        leave_scope();
+        break;
+    }
+}
+
+register_index BytecodeCompiler::expression(const Expression * expression_ptr)
+{
+    if(expression_ptr->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION)
+    {
+        const VariableExpression * var_exp_ptr = static_cast<const VariableExpression *>(expression_ptr);
+        if(!is_defined(var_exp_ptr->get_slot()))
+        {
+            emit(OPCODE::ERROR,string_index("Line: " + std::to_string(var_exp_ptr->get_line_number()) + ", Error: The \"" + var_exp_ptr->get_variable_name() + "\" variable not found"));
+        }
+        return var_exp_ptr->get_slot();
+    }
+    else if(expression_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION)
+    {
+        return constant_register(static_cast<const DecimalExpression *>(expression_ptr)->get_decimal());
+    }
+    else
+    {
+        register_index temporary = new_temporary();
+        expression_to(expression_ptr,temporary);
+        return temporary;
+    }
+}
+
+void BytecodeCompiler::expression_to(const Expression * expression_ptr,register_index target)
+{
+    register_index mark = m_next_temporary;
+    switch(expression_ptr->get_expression_type())
+    {
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    case EXPRESSION::DECIMAL_EXPRESSION:
+    {
+        register_index source = expression(expression_ptr);
+        if(source != target)
+        {
+            emit(OPCODE::MOVE,target,source);
+        }
+        break;
+    }
+    case EXPRESSION::UNARY_EXPRESSION:
+    {
+        const UnaryExpression * unary_exp_ptr = static_cast<const UnaryExpression *>(expression_ptr);
+        register_index source = expression(unary_exp_ptr->get_expression());
+        if(unary_exp_ptr->get_operator() == OPERATOR::SUBSTRACT)
+        {
+            emit(OPCODE::NEGATE,target,source);
+        }
+        else if(unary_exp_ptr->get_operator() == OPERATOR::NOT)
+        {
+            emit(OPCODE::NOT,target,source);
+        }
+        else if(source != target)
+        {
+            emit(OPCODE::MOVE,target,source);
+        }
+        break;
+    }
+    case EXPRESSION::BINARY_EXPRESSION:
+    {
+        //Left operands on the way down the chain, then each operator on the way back up, into the temporary its parent reads
+        struct Link
+        {
+            const BinaryExpression * binary_expression;
+            register_index target;
+            register_index left;
+            std::size_t jump_end;
+        };
+        std::vector<Link> chain;
+        while(expression_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+        {
+            const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(expression_ptr);
+            Link link = {binary_exp_ptr,target,0,0};
+            if(binary_exp_ptr->get_operator() == OPERATOR::AND || binary_exp_ptr->get_operator() == OPERATOR::OR)
+            {
+                //The right operand is only evaluated when it decides the result
+                link.left = target >= m_temporary_base ? target : new_temporary();
+                emit(OPCODE::TEST,link.left,expression(binary_exp_ptr->get_left_expression()));
+                link.jump_end = emit(binary_exp_ptr->get_operator() == OPERATOR::AND ? OPCODE::JUMP_IF_FALSE : OPCODE::JUMP_IF_TRUE,link.left);
+            }
+            else
+            {
+                link.left = expression(binary_exp_ptr->get_left_expression());
+            }
+            chain.push_back(link);
+            expression_ptr = binary_exp_ptr->get_right_expression();
+            if(expression_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+            {
+                target = new_temporary();
+            }
+        }
+        register_index right = expression(expression_ptr);
+        for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            OPERATOR op = it->binary_expression->get_operator();
+            if(op == OPERATOR::AND || op == OPERATOR::OR)
+            {
+                emit(OPCODE::TEST,it->left,right);
+                patch(it->jump_end,here());
+                if(it->left != it->target)
+                {
+                    emit(OPCODE::MOVE,it->target,it->left);
+                }
+            }
+            else
+            {
+                emit(binary_opcode(op),it->target,it->left,right);
+            }
+            right = it->target;
+        }
+        break;
+    }
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        const CallExpression * call_exp_ptr = static_cast<const CallExpression *>(expression_ptr);
+        const NodeList<Expression *> & exps = call_exp_ptr->get_expressions();
+        register_index base = m_next_temporary;
+        for(std::size_t i = 0; i < exps.size(); ++i)
+        {
+            new_temporary();
+        }
+        for(std::size_t i = 0; i < exps.size(); ++i)
+        {
+            expression_to(exps[i],base + register_index(i));
+        }
+        CallSite call_site = {call_exp_ptr->get_function_name(),register_index(exps.size()),call_exp_ptr->get_function()};
+        m_bytecode->m_call_sites.push_back(call_site);
+        emit(OPCODE::CALL,target,register_index(m_bytecode->m_call_sites.size() - 1),base);
+        break;
+    }
+    }
+    m_next_temporary = mark;
+}
+}
+}
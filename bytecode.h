@@ -0,0 +1,130 @@
+#ifndef BYTECODE_H_INCLUDED
+#define BYTECODE_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include "language.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Type register_index
+typedef unsigned int register_index;
+
+//Opcode
+enum class OPCODE : unsigned char
+{
+    //a = b op c
+    PLUS, SUBSTRACT, MULTIPLY, DIVIDE, DIVIDE_EXACTLY, POWER, MOD, EQUAL, GREATER_THEN, LESS_THEN, NOT_EQUAL, GREATER_THEN_OR_EQUAL, LESS_THEN_OR_EQUAL,
+    //a = op b
+    MOVE, NEGATE, NOT, TEST,
+    //a = call_sites[b](c ... c + argc - 1)
+    CALL,
+    //Output and input
+    PRINT, PRINT_STRING, INPUT, INPUT_PROMPT,
+    //Control flow
+    JUMP, JUMP_IF_TRUE, JUMP_IF_NOT_TRUE, JUMP_IF_FALSE, ERROR, HALT
+};
+OPCODE binary_opcode(OPERATOR op);
+
+//Instruction
+struct Instruction
+{
+    OPCODE opcode;
+    register_index a;
+    register_index b;
+    register_index c;
+};
+
+//Call site
+struct CallSite
+{
+    std::string function_name;
+    register_index argument_count;
+    //Bound when parsed, nullptr for an unknown function
+    const Function * function;
+};
+
+//Bytecode
+class Bytecode
+{
+private:
+    std::vector<Instruction> m_instructions;
+    std::vector<sbasic_decimal_type> m_constants;
+    std::vector<std::string> m_strings;
+    std::vector<CallSite> m_call_sites;
+    register_index m_constant_base;
+    register_index m_register_count;
+public:
+    Bytecode() : m_constant_base(0), m_register_count(0) {}
+    const std::vector<Instruction> & get_instructions() const
+    {
+        return m_instructions;
+    }
+    const std::vector<sbasic_decimal_type> & get_constants() const
+    {
+        return m_constants;
+    }
+    const std::vector<std::string> & get_strings() const
+    {
+        return m_strings;
+    }
+    const std::vector<CallSite> & get_call_sites() const
+    {
+        return m_call_sites;
+    }
+    register_index get_constant_base() const
+    {
+        return m_constant_base;
+    }
+    register_index get_register_count() const
+    {
+        return m_register_count;
+    }
+    friend class BytecodeCompiler;
+};
+
+//BytecodeCompiler
+class BytecodeCompiler
+{
+private:
+    Bytecode * m_bytecode;
+    std::map<std::pair<bool,sbasic_decimal_type>,register_index> m_constants;
+    std::vector<char> m_defined_variables;
+    std::vector<variable_slot> m_scope_variables;
+    std::vector<std::size_t> m_scopes;
+    register_index m_temporary_base;
+    register_index m_next_temporary;
+    void collect_stmts(const NodeList<Stmt *> & stmts);
+    void collect_expression(const Expression * expression);
+    register_index constant_register(sbasic_decimal_type decimal);
+    register_index string_index(const std::string & str);
+    register_index new_temporary();
+    bool is_defined(variable_slot slot) const;
+    void define(variable_slot slot);
+    void enter_scope();
+    void leave_scope();
+    std::size_t emit(OPCODE opcode,register_index a = 0,register_index b = 0,register_index c = 0);
+    void patch(std::size_t instruction,register_index target);
+    register_index here() const
+    {
+        return register_index(m_bytecode->m_instructions.size());
+    }
+    void stmts(const NodeList<Stmt *> & stmts);
+    void stmt(const Stmt * stmt);
+    register_index expression(const Expression * expression);
+    void expression_to(const Expression * expression,register_index target);
+public:
+    BytecodeCompiler() : m_bytecode(nullptr), m_temporary_base(0), m_next_temporary(0) {}
+    Bytecode * compile(const Program * program);
+    void delete_bytecode(Bytecode * bytecode)
+    {
+        delete bytecode;
+    }
+};
+}
+}
+
+#endif // BYTECODE_H_INCLUDED
@@ -0,0 +1,506 @@
+#include "cache.h"
+#include "specialized.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#if defined(__linux__)
+#define SBASIC_CACHE_EXECUTABLE_STAMP
+#include <sys/stat.h>
+#endif // defined
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Bumped whenever the layout below or what the optimizer leaves in the tree changes
+const std::uint64_t CACHE_FORMAT_VERSION = 1;
+const char CACHE_MAGIC[] = {'S','B','A','S','I','C','C','\0'};
+
+//FNV-1a
+static std::uint64_t hash_bytes(const char * begin,const char * end,std::uint64_t hash = 14695981039346656037ULL)
+{
+    for(const char * it = begin; it != end; ++it)
+    {
+        hash ^= static_cast<unsigned char>(*it);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//Identifies the interpreter, so a rebuilt one never trusts the trees an older one wrote
+static std::string interpreter_stamp()
+{
+    std::string stamp = __DATE__ " " __TIME__;
+#if defined SBASIC_CACHE_EXECUTABLE_STAMP
+    struct stat executable_stat;
+    if(stat("/proc/self/exe",&executable_stat) == 0)
+    {
+        stamp += " " + std::to_string(executable_stat.st_size) + " " + std::to_string(executable_stat.st_mtime);
+    }
+#endif // SBASIC_CACHE_EXECUTABLE_STAMP
+    return stamp;
+}
+
+ProgramCache::ProgramCache(const char * file_name,const std::string & cache_directory,const SourceFile & source_file,bool optimized) : m_optimized(optimized), m_buffer(nullptr), m_current(nullptr), m_end(nullptr), m_program(nullptr), m_function_table(nullptr)
+{
+    m_source_hash = hash_bytes(source_file.begin(),source_file.end());
+    m_source_size = source_file.size();
+    if(cache_directory.empty())
+    {
+        m_cache_file_name = std::string(file_name) + ".sbc";
+    }
+    else
+    {
+        //Optimized and unoptimized trees of one source, and each decimal type, get files of their own
+        char key[17];
+        std::snprintf(key,sizeof(key),"%016llx",static_cast<unsigned long long>(m_source_hash ^ (optimized ? 0 : 1) ^ (sizeof(sbasic_decimal_type) << 1)));
+        m_cache_file_name = cache_directory + "/" + key + ".sbc";
+    }
+}
+
+Program * ProgramCache::load(const FunctionTable & function_table)
+{
+    m_function_table = &function_table;
+    try
+    {
+        SourceFile cache_file(m_cache_file_name.c_str());
+        m_current = cache_file.begin();
+        m_end = cache_file.end();
+        m_program = new Program();
+        try
+        {
+            read_header();
+            std::uint64_t variable_count = read_integer(4,std::numeric_limits<variable_slot>::max());
+            for(std::uint64_t i = 0; i < variable_count; ++i)
+            {
+                m_program->add_variable_name(read_string());
+            }
+            m_program->set_stmts(read_stmts());
+            if(m_current != m_end)
+            {
+                throw StaleCache();
+            }
+        }
+        catch(StaleCache &)
+        {
+            delete m_program;
+            m_program = nullptr;
+        }
+    }
+    catch(std::string &)
+    {
+        //No cache file yet
+        m_program = nullptr;
+    }
+    Program * program = m_program;
+    m_program = nullptr;
+    m_current = m_end = nullptr;
+    m_function_table = nullptr;
+    return program;
+}
+
+void ProgramCache::store(const Program * program)
+{
+    std::string buffer;
+    m_buffer = &buffer;
+    header();
+    write_integer(program->get_variable_count(),4);
+    for(auto it = program->get_variable_names().begin(); it != program->get_variable_names().end(); ++it)
+    {
+        write_string(*it);
+    }
+    write_stmts(program->get_stmts());
+    m_buffer = nullptr;
+    //Renamed into place once complete, a concurrent run never maps half a file
+    std::string temporary_file_name = m_cache_file_name + ".tmp";
+    {
+        std::ofstream cache_file(temporary_file_name,std::ios::binary | std::ios::trunc);
+        if(!(cache_file << buffer))
+        {
+            cache_file.close();
+            std::remove(temporary_file_name.c_str());
+            return;
+        }
+    }
+    if(std::rename(temporary_file_name.c_str(),m_cache_file_name.c_str()) != 0)
+    {
+        std::remove(temporary_file_name.c_str());
+    }
+}
+
+//Writer, integers are little endian of a fixed width
+void ProgramCache::header()
+{
+    write_bytes(CACHE_MAGIC,sizeof(CACHE_MAGIC));
+    write_integer(CACHE_FORMAT_VERSION,4);
+    write_integer(sizeof(sbasic_decimal_type),1);
+    write_integer(m_optimized ? 1 : 0,1);
+    write_integer(m_source_hash,8);
+    write_integer(m_source_size,8);
+    write_string(interpreter_stamp());
+}
+void ProgramCache::write_bytes(const void * data,std::size_t size)
+{
+    m_buffer->append(static_cast<const char *>(data),size);
+}
+void ProgramCache::write_integer(std::uint64_t integer,std::size_t size)
+{
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        m_buffer->push_back(char((integer >> (8 * i)) & 0xFF));
+    }
+}
+void ProgramCache::write_string(const std::string & str)
+{
+    write_integer(str.size(),4);
+    write_bytes(str.data(),str.size());
+}
+void ProgramCache::write_stmts(const NodeList<Stmt *> & stmts)
+{
+    write_integer(stmts.size(),4);
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        write_stmt(*it);
+    }
+}
+void ProgramCache::write_stmt(const Stmt * stmt)
+{
+    write_integer(static_cast<std::uint64_t>(stmt->get_stmt_type()),1);
+    switch(stmt->get_stmt_type())
+    {
+    case STMT::PRINT_STMT:
+    {
+        const PrintStmt * print_stmt_ptr = static_cast<const PrintStmt *>(stmt);
+        write_integer(print_stmt_ptr->has_prompt() ? 1 : 0,1);
+        if(print_stmt_ptr->has_prompt())
+        {
+            write_string(print_stmt_ptr->get_prompt());
+        }
+        write_expressions(print_stmt_ptr->get_expressions());
+        break;
+    }
+    case STMT::INPUT_STMT:
+    {
+        const InputStmt * input_stmt_ptr = static_cast<const InputStmt *>(stmt);
+        write_integer(input_stmt_ptr->has_prompt() ? 1 : 0,1);
+        if(input_stmt_ptr->has_prompt())
+        {
+            write_string(input_stmt_ptr->get_prompt());
+        }
+        const NodeList<VariableExpression *> & exps = input_stmt_ptr->get_expressions();
+        write_integer(exps.size(),4);
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            write_expression(*it);
+        }
+        break;
+    }
+    case STMT::ASSIGNMENT_STMT:
+        write_expression(static_cast<const AssignmentStmt *>(stmt)->get_variable_expression());
+        write_expression(static_cast<const AssignmentStmt *>(stmt)->get_expression());
+        break;
+    case STMT::DO_ITERATOR_STMT:
+        write_stmts(static_cast<const DOIteratorStmt *>(stmt)->get_stmts());
+        write_expression(static_cast<const DOIteratorStmt *>(stmt)->get_condition());
+        break;
+    case STMT::SELECTION_STMT:
+        write_expression(static_cast<const SelectionStmt *>(stmt)->get_condition());
+        write_stmts(static_cast<const SelectionStmt *>(stmt)->get_true_stmts());
+        write_stmts(static_cast<const SelectionStmt *>(stmt)->get_false_stmts());
+        break;
+    case STMT::WHILE_ITERATOR_STMT:
+        write_expression(static_cast<const WHILEIteratorStmt *>(stmt)->get_condition());
+        write_stmts(static_cast<const WHILEIteratorStmt *>(stmt)->get_stmts());
+        break;
+    case STMT::BLOCK_STMT:
+        write_stmts(static_cast<const BlockStmt *>(stmt)->get_stmts());
+        break;
+    }
+}
+void ProgramCache::write_expressions(const NodeList<Expression *> & expressions)
+{
+    write_integer(expressions.size(),4);
+    for(auto it = expressions.begin(); it != expressions.end(); ++it)
+    {
+        write_expression(*it);
+    }
+}
+void ProgramCache::write_expression(const Expression * expression)
+{
+    //The same preorder as a recursive walk, with right operands in a loop
+    while(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        write_integer(static_cast<std::uint64_t>(EXPRESSION::BINARY_EXPRESSION),1);
+        write_integer(static_cast<std::uint64_t>(static_cast<const BinaryExpression *>(expression)->get_operator()),1);
+        write_expression(static_cast<const BinaryExpression *>(expression)->get_left_expression());
+        expression = static_cast<const BinaryExpression *>(expression)->get_right_expression();
+    }
+    write_integer(static_cast<std::uint64_t>(expression->get_expression_type()),1);
+    switch(expression->get_expression_type())
+    {
+    case EXPRESSION::UNARY_EXPRESSION:
+        write_integer(static_cast<std::uint64_t>(static_cast<const UnaryExpression *>(expression)->get_operator()),1);
+        write_expression(static_cast<const UnaryExpression *>(expression)->get_expression());
+        break;
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    {
+        const VariableExpression * variable_exp_ptr = static_cast<const VariableExpression *>(expression);
+        write_string(variable_exp_ptr->get_variable_name());
+        write_integer(variable_exp_ptr->get_line_number(),4);
+        write_integer(variable_exp_ptr->get_slot(),4);
+        break;
+    }
+    case EXPRESSION::BINARY_EXPRESSION:
+        break;
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        const CallExpression * call_exp_ptr = static_cast<const CallExpression *>(expression);
+        write_string(call_exp_ptr->get_function_name());
+        write_integer(call_exp_ptr->get_line_number(),4);
+        write_expressions(call_exp_ptr->get_expressions());
+        break;
+    }
+    case EXPRESSION::DECIMAL_EXPRESSION:
+    {
+        sbasic_decimal_type decimal = static_cast<const DecimalExpression *>(expression)->get_decimal();
+        write_bytes(&decimal,sizeof(decimal));
+        break;
+    }
+    }
+}
+
+//Reader, nodes are rebuilt by the same factories as the parser's, so they come back specialized
+void ProgramCache::read_header()
+{
+    char magic[sizeof(CACHE_MAGIC)];
+    read_bytes(magic,sizeof(magic));
+    if(std::memcmp(magic,CACHE_MAGIC,sizeof(magic)) != 0
+            || read_integer(4,CACHE_FORMAT_VERSION) != CACHE_FORMAT_VERSION
+            || read_integer(1,sizeof(sbasic_decimal_type)) != sizeof(sbasic_decimal_type)
+            || read_integer(1,1) != (m_optimized ? 1 : 0)
+            || read_integer(8,std::numeric_limits<std::uint64_t>::max()) != m_source_hash
+            || read_integer(8,std::numeric_limits<std::uint64_t>::max()) != m_source_size
+            || read_string() != interpreter_stamp())
+    {
+        throw StaleCache();
+    }
+}
+void ProgramCache::read_bytes(void * data,std::size_t size)
+{
+    if(std::size_t(m_end - m_current) < size)
+    {
+        throw StaleCache();
+    }
+    std::memcpy(data,m_current,size);
+    m_current += size;
+}
+std::uint64_t ProgramCache::read_integer(std::size_t size,std::uint64_t limit)
+{
+    if(std::size_t(m_end - m_current) < size)
+    {
+        throw StaleCache();
+    }
+    std::uint64_t integer = 0;
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        integer |= std::uint64_t(static_cast<unsigned char>(m_current[i])) << (8 * i);
+    }
+    m_current += size;
+    if(integer > limit)
+    {
+        throw StaleCache();
+    }
+    return integer;
+}
+//Copied into the program arena, the cache file is unmapped after loading
+const char * ProgramCache::read_string()
+{
+    std::size_t length = read_integer(4,std::numeric_limits<std::uint32_t>::max());
+    //Checked once the length itself is read, so the copy never runs past the file
+    if(length > std::size_t(m_end - m_current))
+    {
+        throw StaleCache();
+    }
+    const char * str = m_program->get_arena().create_string(m_current,length);
+    m_current += length;
+    return str;
+}
+NodeList<Stmt *> ProgramCache::read_stmts()
+{
+    std::uint64_t count = read_integer(4,std::size_t(m_end - m_current));
+    std::vector<Stmt *> stmt_vector;
+    stmt_vector.reserve(count);
+    for(std::uint64_t i = 0; i < count; ++i)
+    {
+        stmt_vector.push_back(read_stmt());
+    }
+    return m_program->get_arena().create_list(stmt_vector);
+}
+Stmt * ProgramCache::read_stmt()
+{
+    Arena & arena = m_program->get_arena();
+    switch(static_cast<STMT>(read_integer(1,static_cast<std::uint64_t>(STMT::BLOCK_STMT))))
+    {
+    case STMT::PRINT_STMT:
+    {
+        PrintStmt * print_stmt_ptr = arena.create<PrintStmt>();
+        if(read_integer(1,1))
+        {
+            print_stmt_ptr->set_prompt(read_string());
+        }
+        print_stmt_ptr->set_expressions(read_expressions());
+        return print_stmt_ptr;
+    }
+    case STMT::INPUT_STMT:
+    {
+        InputStmt * input_stmt_ptr = arena.create<InputStmt>();
+        if(read_integer(1,1))
+        {
+            input_stmt_ptr->set_prompt(read_string());
+        }
+        std::uint64_t count = read_integer(4,std::size_t(m_end - m_current));
+        std::vector<VariableExpression *> vars_vector;
+        for(std::uint64_t i = 0; i < count; ++i)
+        {
+            vars_vector.push_back(read_variable());
+        }
+        input_stmt_ptr->set_expressions(arena.create_list(vars_vector));
+        return input_stmt_ptr;
+    }
+    case STMT::ASSIGNMENT_STMT:
+    {
+        AssignmentStmt * assignment_stmt_ptr = arena.create<AssignmentStmt>();
+        assignment_stmt_ptr->set_variable_expression(read_variable());
+        assignment_stmt_ptr->set_expression(read_expression());
+        return assignment_stmt_ptr;
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        DOIteratorStmt * do_stmt_ptr = arena.create<DOIteratorStmt>();
+        do_stmt_ptr->set_stmts(read_stmts());
+        do_stmt_ptr->set_condition(read_expression());
+        return do_stmt_ptr;
+    }
+    case STMT::SELECTION_STMT:
+    {
+        SelectionStmt * selection_stmt_ptr = arena.create<SelectionStmt>();
+        selection_stmt_ptr->set_condition(read_expression());
+        selection_stmt_ptr->set_true_stmts(read_stmts());
+        selection_stmt_ptr->set_false_stmts(read_stmts());
+        return selection_stmt_ptr;
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        WHILEIteratorStmt * while_stmt_ptr = arena.create<WHILEIteratorStmt>();
+        while_stmt_ptr->set_condition(read_expression());
+        while_stmt_ptr->set_stmts(read_stmts());
+        return while_stmt_ptr;
+    }
+    case STMT::BLOCK_STMT:
+    {
+        BlockStmt * block_stmt_ptr = arena.create<BlockStmt>();
+        block_stmt_ptr->set_stmts(read_stmts());
+        return block_stmt_ptr;
+    }
+    }
+    throw StaleCache();
+}
+NodeList<Expression *> ProgramCache::read_expressions()
+{
+    std::uint64_t count = read_integer(4,std::size_t(m_end - m_current));
+    std::vector<Expression *> exp_vector;
+    exp_vector.reserve(count);
+    for(std::uint64_t i = 0; i < count; ++i)
+    {
+        exp_vector.push_back(read_expression());
+    }
+    return m_program->get_arena().create_list(exp_vector);
+}
+Expression * ProgramCache::read_expression()
+{
+    Arena & arena = m_program->get_arena();
+    EXPRESSION expression_type = static_cast<EXPRESSION>(read_integer(1,static_cast<std::uint64_t>(EXPRESSION::DECIMAL_EXPRESSION)));
+    switch(expression_type)
+    {
+    case EXPRESSION::UNARY_EXPRESSION:
+    {
+        OPERATOR op = static_cast<OPERATOR>(read_integer(1,static_cast<std::uint64_t>(OPERATOR::NOT)));
+        if(op != OPERATOR::PLUS && op != OPERATOR::SUBSTRACT && op != OPERATOR::NOT)
+        {
+            throw StaleCache();
+        }
+        return create_unary_expression(arena,op,read_expression());
+    }
+    case EXPRESSION::VARIABLE_EXPRESSION:
+        //Back up to the type, read_variable reads it again
+        --m_current;
+        return read_variable();
+    case EXPRESSION::BINARY_EXPRESSION:
+    {
+        //Operators and left operands down the chain, then built from its last right operand up
+        std::vector<std::pair<OPERATOR,Expression *>> chain;
+        do
+        {
+            OPERATOR op = static_cast<OPERATOR>(read_integer(1,static_cast<std::uint64_t>(OPERATOR::OR)));
+            Expression * left_exp_ptr = read_expression();
+            chain.push_back(std::make_pair(op,left_exp_ptr));
+            expression_type = static_cast<EXPRESSION>(read_integer(1,static_cast<std::uint64_t>(EXPRESSION::DECIMAL_EXPRESSION)));
+        }
+        while(expression_type == EXPRESSION::BINARY_EXPRESSION);
+        //Back up to the type, read_expression reads it again
+        --m_current;
+        Expression * exp_ptr = read_expression();
+        for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            exp_ptr = create_binary_expression(arena,it->first,it->second,exp_ptr);
+        }
+        return exp_ptr;
+    }
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        CallExpression * call_exp_ptr = arena.create<CallExpression>();
+        call_exp_ptr->set_function_name(read_string());
+        call_exp_ptr->set_line_number(line_number(read_integer(4,std::numeric_limits<line_number>::max())));
+        call_exp_ptr->set_expressions(read_expressions());
+        //A table whose arity differs from the one the program was parsed with needs the parser's error
+        const Function * function = m_function_table->find_function(call_exp_ptr->get_function_name());
+        if(function != nullptr && function->arity != call_exp_ptr->get_expressions().size())
+        {
+            throw StaleCache();
+        }
+        call_exp_ptr->set_function(function);
+        return call_exp_ptr;
+    }
+    case EXPRESSION::DECIMAL_EXPRESSION:
+    {
+        sbasic_decimal_type decimal;
+        read_bytes(&decimal,sizeof(decimal));
+        DecimalExpression * decimal_exp_ptr = arena.create<DecimalExpression>();
+        decimal_exp_ptr->set_decimal(decimal);
+        return decimal_exp_ptr;
+    }
+    }
+    throw StaleCache();
+}
+VariableExpression * ProgramCache::read_variable()
+{
+    if(read_integer(1,static_cast<std::uint64_t>(EXPRESSION::DECIMAL_EXPRESSION)) != static_cast<std::uint64_t>(EXPRESSION::VARIABLE_EXPRESSION))
+    {
+        throw StaleCache();
+    }
+    VariableExpression * variable_exp_ptr = m_program->get_arena().create<VariableExpression>();
+    variable_exp_ptr->set_variable_name(read_string());
+    variable_exp_ptr->set_line_number(line_number(read_integer(4,std::numeric_limits<line_number>::max())));
+    //Slots index the VariableTable, one out of range would write past it
+    if(m_program->get_variable_count() == 0)
+    {
+        throw StaleCache();
+    }
+    variable_exp_ptr->set_slot(variable_slot(read_integer(4,m_program->get_variable_count() - 1)));
+    return variable_exp_ptr;
+}
+}
+}
@@ -0,0 +1,56 @@
+#ifndef CACHE_H_INCLUDED
+#define CACHE_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include "language.h"
+#include "source.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//ProgramCache, the parsed and optimized program saved in binary so later runs skip the lexer and parser
+//A cache file is stale, and rewritten, when the source, the interpreter or the options it was built with change
+class ProgramCache
+{
+private:
+    //Thrown while reading a cache file that is stale or damaged
+    struct StaleCache {};
+    std::string m_cache_file_name;
+    std::uint64_t m_source_hash;
+    std::uint64_t m_source_size;
+    bool m_optimized;
+    std::string * m_buffer;
+    const char * m_current;
+    const char * m_end;
+    Program * m_program;
+    const FunctionTable * m_function_table;
+    void header();
+    void write_bytes(const void * data,std::size_t size);
+    void write_integer(std::uint64_t integer,std::size_t size);
+    void write_string(const std::string & str);
+    void write_stmts(const NodeList<Stmt *> & stmts);
+    void write_stmt(const Stmt * stmt);
+    void write_expressions(const NodeList<Expression *> & expressions);
+    void write_expression(const Expression * expression);
+    void read_header();
+    void read_bytes(void * data,std::size_t size);
+    std::uint64_t read_integer(std::size_t size,std::uint64_t limit);
+    const char * read_string();
+    NodeList<Stmt *> read_stmts();
+    Stmt * read_stmt();
+    NodeList<Expression *> read_expressions();
+    Expression * read_expression();
+    VariableExpression * read_variable();
+public:
+    //Without a directory the cache file is written next to the source, with one it is named by the source hash
+    ProgramCache(const char * file_name,const std::string & cache_directory,const SourceFile & source_file,bool optimized);
+    //nullptr when there is no usable cache file, calls are bound to the table as they are read
+    Program * load(const FunctionTable & function_table);
+    //Best effort, a cache that can not be written is skipped
+    void store(const Program * program);
+};
+}
+}
+
+#endif // CACHE_H_INCLUDED
@@ -0,0 +1,506 @@
+#include "closure.h"
+#include "specialized.h"
+#include "output.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Variable read, the same check and message as VariableExpression
+inline sbasic_decimal_type read_variable(VariableTable & variable_table,const VariableExpression * variable_expression,variable_slot slot)
+{
+    if(!variable_table.is_defined(slot))
+    {
+        variable_expression->throw_not_found();
+    }
+    return variable_table.get_variable(slot);
+}
+
+//Arithmetic and comparison values, fused with a variable and a constant operand where possible
+template<OPERATOR OP>
+ExpressionClosure operator_closure(const BinaryExpression * binary_expression,const ExpressionClosure & left,const ExpressionClosure & right)
+{
+    typedef OperationTraits<OP,is_comparison(OP)> Traits;
+    const Expression * left_ptr = binary_expression->get_left_expression();
+    const Expression * right_ptr = binary_expression->get_right_expression();
+    if(left_ptr->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION && right_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION)
+    {
+        const VariableExpression * variable_ptr = static_cast<const VariableExpression *>(left_ptr);
+        variable_slot slot = variable_ptr->get_slot();
+        sbasic_decimal_type constant = static_cast<const DecimalExpression *>(right_ptr)->get_decimal();
+        return [variable_ptr,slot,constant](VariableTable & variable_table)
+        {
+            return Traits::compute(read_variable(variable_table,variable_ptr,slot),constant);
+        };
+    }
+    if(left_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION && right_ptr->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION)
+    {
+        sbasic_decimal_type constant = static_cast<const DecimalExpression *>(left_ptr)->get_decimal();
+        const VariableExpression * variable_ptr = static_cast<const VariableExpression *>(right_ptr);
+        variable_slot slot = variable_ptr->get_slot();
+        return [constant,variable_ptr,slot](VariableTable & variable_table)
+        {
+            return Traits::compute(constant,read_variable(variable_table,variable_ptr,slot));
+        };
+    }
+    return [left,right](VariableTable & variable_table)
+    {
+        //Left first, like BinaryExpression
+        sbasic_decimal_type left_value = left(variable_table);
+        return Traits::compute(left_value,right(variable_table));
+    };
+}
+
+//Comparison conditions, no 0 or 1 is built
+template<OPERATOR OP>
+ConditionClosure comparison_closure(const BinaryExpression * binary_expression,const ExpressionClosure & left,const ExpressionClosure & right)
+{
+    const Expression * left_ptr = binary_expression->get_left_expression();
+    const Expression * right_ptr = binary_expression->get_right_expression();
+    if(left_ptr->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION && right_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION)
+    {
+        const VariableExpression * variable_ptr = static_cast<const VariableExpression *>(left_ptr);
+        variable_slot slot = variable_ptr->get_slot();
+        sbasic_decimal_type constant = static_cast<const DecimalExpression *>(right_ptr)->get_decimal();
+        return [variable_ptr,slot,constant](VariableTable & variable_table)
+        {
+            return Comparison<OP>::test(read_variable(variable_table,variable_ptr,slot),constant);
+        };
+    }
+    return [left,right](VariableTable & variable_table)
+    {
+        sbasic_decimal_type left_value = left(variable_table);
+        return Comparison<OP>::test(left_value,right(variable_table));
+    };
+}
+
+void ClosureProgram::run()
+{
+    VariableTable variable_table(m_variable_count);
+    for(auto it = m_stmts.begin(); it != m_stmts.end(); ++it)
+    {
+        (*it)(variable_table);
+    }
+}
+
+ClosureProgram * ClosureCompiler::compile(const Program * program)
+{
+    ClosureProgram * closure_program = new ClosureProgram();
+    closure_program->m_variable_count = program->get_variable_count();
+    closure_program->m_stmts = stmts(program->get_stmts());
+    return closure_program;
+}
+
+std::vector<StmtClosure> ClosureCompiler::stmts(const NodeList<Stmt *> & stmts)
+{
+    std::vector<StmtClosure> closures;
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        closures.push_back(stmt(*it));
+    }
+    return closures;
+}
+
+StmtClosure ClosureCompiler::sequence(const NodeList<Stmt *> & stmts)
+{
+    if(stmts.size() == 1)
+    {
+        return stmt(stmts[0]);
+    }
+    std::vector<StmtClosure> closures = this->stmts(stmts);
+    return [closures](VariableTable & variable_table)
+    {
+        for(auto it = closures.begin(); it != closures.end(); ++it)
+        {
+            (*it)(variable_table);
+        }
+    };
+}
+
+StmtClosure ClosureCompiler::stmt(const Stmt * stmt_ptr)
+{
+    switch(stmt_ptr->get_stmt_type())
+    {
+    case STMT::PRINT_STMT:
+    {
+        const PrintStmt * print_stmt_ptr = static_cast<const PrintStmt *>(stmt_ptr);
+        bool has_prompt = print_stmt_ptr->has_prompt();
+        std::string prompt = has_prompt ? print_stmt_ptr->get_prompt() : std::string();
+        std::vector<ExpressionClosure> exps;
+        for(auto it = print_stmt_ptr->get_expressions().begin(); it != print_stmt_ptr->get_expressions().end(); ++it)
+        {
+            exps.push_back(expression(*it));
+        }
+        return [has_prompt,prompt,exps](VariableTable & variable_table)
+        {
+            if(has_prompt)
+            {
+                standard_output.write(prompt);
+                standard_output.end_line();
+            }
+            for(auto it = exps.begin(); it != exps.end(); ++it)
+            {
+                standard_output.write_number((*it)(variable_table));
+                standard_output.end_line();
+            }
+        };
+    }
+    case STMT::INPUT_STMT:
+    {
+        const InputStmt * input_stmt_ptr = static_cast<const InputStmt *>(stmt_ptr);
+        std::string prompt = (input_stmt_ptr->has_prompt() ? input_stmt_ptr->get_prompt() : std::string()) + "?";
+        std::vector<variable_slot> slots;
+        for(auto it = input_stmt_ptr->get_expressions().begin(); it != input_stmt_ptr->get_expressions().end(); ++it)
+        {
+            slots.push_back((**it).get_slot());
+        }
+        return [prompt,slots](VariableTable & variable_table)
+        {
+            standard_output.write(prompt);
+            standard_output.before_input();
+            for(auto it = slots.begin(); it != slots.end(); ++it)
+            {
+                sbasic_decimal_type sdt;
+                std::cin >> sdt;
+                variable_table.assign_variable(*it,sdt);
+            }
+        };
+    }
+    case STMT::ASSIGNMENT_STMT:
+    {
+        const AssignmentStmt * assignment_stmt_ptr = static_cast<const AssignmentStmt *>(stmt_ptr);
+        variable_slot slot = assignment_stmt_ptr->get_variable_expression()->get_slot();
+        ExpressionClosure exp = expression(assignment_stmt_ptr->get_expression());
+        return [slot,exp](VariableTable & variable_table)
+        {
+            variable_table.assign_variable(slot,exp(variable_table));
+        };
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        const DOIteratorStmt * do_stmt_ptr = static_cast<const DOIteratorStmt *>(stmt_ptr);
+        StmtClosure body = sequence(do_stmt_ptr->get_stmts());
+        ConditionClosure again = until_condition(do_stmt_ptr->get_condition());
+        return [body,again](VariableTable & variable_table)
+        {
+            do
+            {
+                std::size_t block = variable_table.mark();
+                body(variable_table);
+                variable_table.reset(block);
+            }
+            while(again(variable_table));
+        };
+    }
+    case STMT::SELECTION_STMT:
+    {
+        const SelectionStmt * selection_stmt_ptr = static_cast<const SelectionStmt *>(stmt_ptr);
+        ConditionClosure cond = condition(selection_stmt_ptr->get_condition());
+        StmtClosure true_body = sequence(selection_stmt_ptr->get_true_stmts());
+        StmtClosure false_body = sequence(selection_stmt_ptr->get_false_stmts());
+        return [cond,true_body,false_body](VariableTable & variable_table)
+        {
+            std::size_t block = variable_table.mark();
+            if(cond(variable_table))
+            {
+                true_body(variable_table);
+            }
+            else
+            {
+                false_body(variable_table);
+            }
+            variable_table.reset(block);
+        };
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        const WHILEIteratorStmt * while_stmt_ptr = static_cast<const WHILEIteratorStmt *>(stmt_ptr);
+        ConditionClosure cond = condition(while_stmt_ptr->get_condition());
+        StmtClosure body = sequence(while_stmt_ptr->get_stmts());
+        return [cond,body](VariableTable & variable_table)
+        {
+            while(cond(variable_table))
+            {
+                std::size_t block = variable_table.mark();
+                body(variable_table);
+                variable_table.reset(block);
+            }
+        };
+    }
+    case STMT::BLOCK_STMT:
+    {
+        StmtClosure body = sequence(static_cast<const BlockStmt *>(stmt_ptr)->get_stmts());
+        return [body](VariableTable & variable_table)
+        {
+            std::size_t block = variable_table.mark();
+            body(variable_table);
+            variable_table.reset(block);
+        };
+    }
+    }
+    return [](VariableTable &) {};
+}
+
+ExpressionClosure ClosureCompiler::expression(const Expression * expression_ptr)
+{
+    switch(expression_ptr->get_expression_type())
+    {
+    case EXPRESSION::UNARY_EXPRESSION:
+    {
+        const UnaryExpression * unary_exp_ptr = static_cast<const UnaryExpression *>(expression_ptr);
+        ExpressionClosure exp = expression(unary_exp_ptr->get_expression());
+        if(unary_exp_ptr->get_operator() == OPERATOR::PLUS)
+        {
+            return exp;
+        }
+        else if(unary_exp_ptr->get_operator() == OPERATOR::SUBSTRACT)
+        {
+            return [exp](VariableTable & variable_table)
+            {
+                return -exp(variable_table);
+            };
+        }
+        ConditionClosure cond = condition(unary_exp_ptr);
+        return [cond](VariableTable & variable_table)
+        {
+            return cond(variable_table) ? sbasic_true : sbasic_false;
+        };
+    }
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    {
+        const VariableExpression * variable_ptr = static_cast<const VariableExpression *>(expression_ptr);
+        variable_slot slot = variable_ptr->get_slot();
+        return [variable_ptr,slot](VariableTable & variable_table)
+        {
+            return read_variable(variable_table,variable_ptr,slot);
+        };
+    }
+    case EXPRESSION::BINARY_EXPRESSION:
+        return binary(static_cast<const BinaryExpression *>(expression_ptr));
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        //Bound when parsed, an unknown function fails when it is called
+        const CallExpression * call_exp_ptr = static_cast<const CallExpression *>(expression_ptr);
+        std::string function_name = call_exp_ptr->get_function_name();
+        sbasic_function_pointer function = call_exp_ptr->get_function() != nullptr ? call_exp_ptr->get_function()->pointer : nullptr;
+        std::vector<ExpressionClosure> args;
+        for(auto it = call_exp_ptr->get_expressions().begin(); it != call_exp_ptr->get_expressions().end(); ++it)
+        {
+            args.push_back(expression(*it));
+        }
+        return [function_name,function,args](VariableTable & variable_table)
+        {
+            sbasic_decimal_type values[MAX_FUNCTION_ARITY];
+            for(std::size_t i = 0; i < args.size(); ++i)
+            {
+                //An unknown function may have more arguments, they only run for their errors
+                sbasic_decimal_type value = args[i](variable_table);
+                if(i < MAX_FUNCTION_ARITY)
+                {
+                    values[i] = value;
+                }
+            }
+            if(function == nullptr)
+            {
+                throw "The \"" + function_name + "\" function not found";
+            }
+            return function(values);
+        };
+    }
+    case EXPRESSION::DECIMAL_EXPRESSION:
+    {
+        sbasic_decimal_type constant = static_cast<const DecimalExpression *>(expression_ptr)->get_decimal();
+        return [constant](VariableTable &)
+        {
+            return constant;
+        };
+    }
+    }
+    return [](VariableTable &)
+    {
+        return sbasic_false;
+    };
+}
+
+ExpressionClosure ClosureCompiler::binary(const BinaryExpression * binary_expression)
+{
+    if(binary_expression->get_chain_length() > MAX_NESTED_OPERATORS)
+    {
+        return chain(binary_expression);
+    }
+    OPERATOR op = binary_expression->get_operator();
+    if(op == OPERATOR::AND || op == OPERATOR::OR)
+    {
+        ConditionClosure cond = condition(binary_expression);
+        return [cond](VariableTable & variable_table)
+        {
+            return cond(variable_table) ? sbasic_true : sbasic_false;
+        };
+    }
+    ExpressionClosure left = expression(binary_expression->get_left_expression());
+    ExpressionClosure right = expression(binary_expression->get_right_expression());
+    switch(op)
+    {
+    case OPERATOR::PLUS:
+        return operator_closure<OPERATOR::PLUS>(binary_expression,left,right);
+    case OPERATOR::SUBSTRACT:
+        return operator_closure<OPERATOR::SUBSTRACT>(binary_expression,left,right);
+    case OPERATOR::MULTIPLY:
+        return operator_closure<OPERATOR::MULTIPLY>(binary_expression,left,right);
+    case OPERATOR::DIVIDE:
+        return operator_closure<OPERATOR::DIVIDE>(binary_expression,left,right);
+    case OPERATOR::DIVIDE_EXACTLY:
+        return operator_closure<OPERATOR::DIVIDE_EXACTLY>(binary_expression,left,right);
+    case OPERATOR::POWER:
+        return operator_closure<OPERATOR::POWER>(binary_expression,left,right);
+    case OPERATOR::MOD:
+        return operator_closure<OPERATOR::MOD>(binary_expression,left,right);
+    case OPERATOR::EQUAL:
+        return operator_closure<OPERATOR::EQUAL>(binary_expression,left,right);
+    case OPERATOR::GREATER_THEN:
+        return operator_closure<OPERATOR::GREATER_THEN>(binary_expression,left,right);
+    case OPERATOR::LESS_THEN:
+        return operator_closure<OPERATOR::LESS_THEN>(binary_expression,left,right);
+    case OPERATOR::NOT_EQUAL:
+        return operator_closure<OPERATOR::NOT_EQUAL>(binary_expression,left,right);
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+        return operator_closure<OPERATOR::GREATER_THEN_OR_EQUAL>(binary_expression,left,right);
+    case OPERATOR::LESS_THEN_OR_EQUAL:
+        return operator_closure<OPERATOR::LESS_THEN_OR_EQUAL>(binary_expression,left,right);
+    default:
+        throw std::string("Unknown binary operator");
+    }
+}
+
+//Closures nest like the nodes they come from, a long chain is one closure looping over its operands like ChainExpression
+ExpressionClosure ClosureCompiler::chain(const BinaryExpression * binary_expression)
+{
+    std::vector<OPERATOR> ops;
+    std::vector<ExpressionClosure> lefts;
+    const Expression * exp_ptr = binary_expression;
+    while(exp_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        ops.push_back(static_cast<const BinaryExpression *>(exp_ptr)->get_operator());
+        lefts.push_back(expression(static_cast<const BinaryExpression *>(exp_ptr)->get_left_expression()));
+        exp_ptr = static_cast<const BinaryExpression *>(exp_ptr)->get_right_expression();
+    }
+    ExpressionClosure last = expression(exp_ptr);
+    return [ops,lefts,last](VariableTable & variable_table)
+    {
+        std::vector<sbasic_decimal_type> left_values;
+        left_values.reserve(ops.size());
+        sbasic_decimal_type value = sbasic_false;
+        bool decided = false;
+        while(left_values.size() < ops.size())
+        {
+            sbasic_decimal_type left = lefts[left_values.size()](variable_table);
+            if(is_decided(ops[left_values.size()],left))
+            {
+                value = left == sbasic_true ? sbasic_true : sbasic_false;
+                decided = true;
+                break;
+            }
+            left_values.push_back(left);
+        }
+        if(!decided)
+        {
+            value = last(variable_table);
+        }
+        for(std::size_t i = left_values.size(); i-- > 0;)
+        {
+            value = compute_operator(ops[i],left_values[i],value);
+        }
+        return value;
+    };
+}
+
+ConditionClosure ClosureCompiler::condition(const Expression * expression_ptr)
+{
+    //Whether the value equals sbasic_true, see Expression::test
+    if(expression_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION && static_cast<const BinaryExpression *>(expression_ptr)->get_chain_length() <= MAX_NESTED_OPERATORS)
+    {
+        const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(expression_ptr);
+        OPERATOR op = binary_exp_ptr->get_operator();
+        if(op == OPERATOR::AND || op == OPERATOR::OR)
+        {
+            ConditionClosure left = condition(binary_exp_ptr->get_left_expression());
+            ConditionClosure right = condition(binary_exp_ptr->get_right_expression());
+            if(op == OPERATOR::AND)
+            {
+                return [left,right](VariableTable & variable_table)
+                {
+                    return left(variable_table) && right(variable_table);
+                };
+            }
+            return [left,right](VariableTable & variable_table)
+            {
+                return left(variable_table) || right(variable_table);
+            };
+        }
+        if(is_comparison(op))
+        {
+            ExpressionClosure left = expression(binary_exp_ptr->get_left_expression());
+            ExpressionClosure right = expression(binary_exp_ptr->get_right_expression());
+            switch(op)
+            {
+            case OPERATOR::EQUAL:
+                return comparison_closure<OPERATOR::EQUAL>(binary_exp_ptr,left,right);
+            case OPERATOR::GREATER_THEN:
+                return comparison_closure<OPERATOR::GREATER_THEN>(binary_exp_ptr,left,right);
+            case OPERATOR::LESS_THEN:
+                return comparison_closure<OPERATOR::LESS_THEN>(binary_exp_ptr,left,right);
+            case OPERATOR::NOT_EQUAL:
+                return comparison_closure<OPERATOR::NOT_EQUAL>(binary_exp_ptr,left,right);
+            case OPERATOR::GREATER_THEN_OR_EQUAL:
+                return comparison_closure<OPERATOR::GREATER_THEN_OR_EQUAL>(binary_exp_ptr,left,right);
+            default:
+                return comparison_closure<OPERATOR::LESS_THEN_OR_EQUAL>(binary_exp_ptr,left,right);
+            }
+        }
+    }
+    else if(expression_ptr->get_expression_type() == EXPRESSION::UNARY_EXPRESSION && static_cast<const UnaryExpression *>(expression_ptr)->get_operator() == OPERATOR::NOT)
+    {
+        const Expression * operand_ptr = static_cast<const UnaryExpression *>(expression_ptr)->get_expression();
+        if(operand_ptr->is_boolean())
+        {
+            ConditionClosure cond = condition(operand_ptr);
+            return [cond](VariableTable & variable_table)
+            {
+                return !cond(variable_table);
+            };
+        }
+        ExpressionClosure exp = expression(operand_ptr);
+        return [exp](VariableTable & variable_table)
+        {
+            return exp(variable_table) == sbasic_false;
+        };
+    }
+    ExpressionClosure exp = expression(expression_ptr);
+    return [exp](VariableTable & variable_table)
+    {
+        return exp(variable_table) == sbasic_true;
+    };
+}
+
+ConditionClosure ClosureCompiler::until_condition(const Expression * expression_ptr)
+{
+    //LOOP UNTIL repeats while the value is sbasic_false
+    if(expression_ptr->is_boolean())
+    {
+        ConditionClosure cond = condition(expression_ptr);
+        return [cond](VariableTable & variable_table)
+        {
+            return !cond(variable_table);
+        };
+    }
+    ExpressionClosure exp = expression(expression_ptr);
+    return [exp](VariableTable & variable_table)
+    {
+        return exp(variable_table) == sbasic_false;
+    };
+}
+}
+}
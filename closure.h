@@ -0,0 +1,51 @@
+#ifndef CLOSURE_H_INCLUDED
+#define CLOSURE_H_INCLUDED
+
+#include <functional>
+#include <vector>
+#include "language.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Closures, bound once to slots, constants and function pointers
+typedef std::function<sbasic_decimal_type(VariableTable &)> ExpressionClosure;
+typedef std::function<bool(VariableTable &)> ConditionClosure;
+typedef std::function<void(VariableTable &)> StmtClosure;
+
+//ClosureProgram
+class ClosureProgram
+{
+private:
+    std::vector<StmtClosure> m_stmts;
+    std::size_t m_variable_count;
+public:
+    ClosureProgram() : m_variable_count(0) {}
+    void run();
+    friend class ClosureCompiler;
+};
+
+//ClosureCompiler
+class ClosureCompiler
+{
+private:
+    std::vector<StmtClosure> stmts(const NodeList<Stmt *> & stmts);
+    StmtClosure sequence(const NodeList<Stmt *> & stmts);
+    StmtClosure stmt(const Stmt * stmt);
+    ExpressionClosure expression(const Expression * expression);
+    ExpressionClosure binary(const BinaryExpression * binary_expression);
+    ExpressionClosure chain(const BinaryExpression * binary_expression);
+    ConditionClosure condition(const Expression * expression);
+    ConditionClosure until_condition(const Expression * expression);
+public:
+    ClosureCompiler() {}
+    ClosureProgram * compile(const Program * program);
+    void delete_program(ClosureProgram * closure_program)
+    {
+        delete closure_program;
+    }
+};
+}
+}
+
+#endif // CLOSURE_H_INCLUDED
@@ -0,0 +1,9 @@
+REM Calls the functions of the example plugin
+REM SBASIC --plugin=./libsbasic_example.so examples/plugin.bas
+PRINT HYPOT(3, 4)
+I = 0
+WHILE I < 5
+    PRINT CLAMP(I * 3 - 4, 0, 6)
+    I = I + 1
+WEND
+END
@@ -0,0 +1,22 @@
+#include <cmath>
+#include "plugin.h"
+
+//An example plugin, see examples/plugin.bas
+
+static double hypot2(double x,double y)
+{
+    return std::hypot(x,y);
+}
+
+static double clamp(double x,double low,double high)
+{
+    return x < low ? low : (x > high ? high : x);
+}
+
+static const sbasic_plugin_function FUNCTIONS[] =
+{
+    SBASIC::plugin_function<&hypot2>("HYPOT"),
+    SBASIC::plugin_function<&clamp>("CLAMP")
+};
+
+SBASIC_PLUGIN(FUNCTIONS)
@@ -0,0 +1,914 @@
+#include "jit.h"
+#include "specialized.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined SBASIC_JIT
+#include <sys/mman.h>
+#endif // defined
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Instruction prefixes, scalar double and packed double
+const unsigned char SCALAR = 0xF2;
+const unsigned char PACKED = 0x66;
+//Opcodes after 0F
+const unsigned char MOVSD_LOAD = 0x10;
+const unsigned char MOVSD_STORE = 0x11;
+const unsigned char MOVAPD = 0x28;
+const unsigned char CVTSI2SD = 0x2A;
+const unsigned char CVTTSD2SI = 0x2C;
+const unsigned char MOVMSKPD = 0x50;
+const unsigned char ANDPD = 0x54;
+const unsigned char ORPD = 0x56;
+const unsigned char XORPD = 0x57;
+const unsigned char ADDSD = 0x58;
+const unsigned char MULSD = 0x59;
+const unsigned char SUBSD = 0x5C;
+const unsigned char DIVSD = 0x5E;
+const unsigned char MOVQ = 0x6E;
+const unsigned char CMPSD = 0xC2;
+//cmpsd predicates, the mask is all ones when the comparison holds
+const unsigned char COMPARE_EQUAL = 0;
+const unsigned char COMPARE_LESS = 1;
+const unsigned char COMPARE_LESS_OR_EQUAL = 2;
+const unsigned char COMPARE_NOT_EQUAL = 4;
+//General registers
+const unsigned int RAX = 0;
+const unsigned int RCX = 1;
+const unsigned int RDX = 2;
+
+//xmm0 - xmm7 hold temporaries, xmm8 - xmm15 the most used variables
+const unsigned int TEMPORARY_REGISTERS = 8;
+const unsigned int VARIABLE_REGISTERS = 8;
+//Slots stay inside a 32-bit displacement from rdi
+const variable_slot MAX_NATIVE_SLOT = 0x0FFFFFFF;
+
+void X86Assembler::dword(std::uint32_t d)
+{
+    for(int i = 0; i < 4; ++i)
+    {
+        byte((d >> (i * 8)) & 0xFF);
+    }
+}
+void X86Assembler::rex(bool wide,unsigned int reg,unsigned int rm)
+{
+    unsigned char prefix = 0x40 | (wide ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0);
+    if(prefix != 0x40)
+    {
+        byte(prefix);
+    }
+}
+void X86Assembler::sse(unsigned char prefix,unsigned char opcode,unsigned int reg,unsigned int rm,bool wide)
+{
+    byte(prefix);
+    rex(wide,reg,rm);
+    byte(0x0F);
+    byte(opcode);
+    byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+void X86Assembler::sse_memory(unsigned char prefix,unsigned char opcode,unsigned int reg,std::int32_t displacement)
+{
+    byte(prefix);
+    rex(false,reg,0);
+    byte(0x0F);
+    byte(opcode);
+    //mod 10, rm 111: [rdi + disp32]
+    byte(0x87 | ((reg & 7) << 3));
+    dword(std::uint32_t(displacement));
+}
+void X86Assembler::compare(unsigned int reg,unsigned int rm,unsigned char predicate)
+{
+    sse(SCALAR,CMPSD,reg,rm);
+    byte(predicate);
+}
+void X86Assembler::load_constant(unsigned int reg,sbasic_decimal_type decimal)
+{
+    //Native code only runs with double slots, other builds never get here
+    double value = double(decimal);
+    std::uint64_t bits;
+    std::memcpy(&bits,&value,sizeof(bits));
+    if(bits == 0)
+    {
+        sse(PACKED,XORPD,reg,reg);
+        return;
+    }
+    //mov rax, imm64; movq reg, rax
+    byte(0x48);
+    byte(0xB8);
+    dword(std::uint32_t(bits));
+    dword(std::uint32_t(bits >> 32));
+    sse(PACKED,MOVQ,reg,RAX,true);
+}
+void X86Assembler::truncate(unsigned int reg)
+{
+    //sbasic_divide_exactly, int64(x) in range and x itself past 2^63, where it is already whole
+    sse(SCALAR,CVTTSD2SI,RAX,reg,true);
+    compare_one(RAX);
+    std::size_t whole_jump = jump(JUMP::IF_OVERFLOW);
+    sse(SCALAR,CVTSI2SD,reg,RAX,true);
+    patch(whole_jump,position());
+}
+void X86Assembler::remainder(unsigned int left,unsigned int right)
+{
+    //sbasic_mod, idiv when both operands fit in 64 bits and the divisor is not zero
+    sse(SCALAR,CVTTSD2SI,RAX,left,true);
+    sse(SCALAR,CVTTSD2SI,RCX,right,true);
+    compare_one(RAX);
+    std::size_t left_jump = jump(JUMP::IF_OVERFLOW);
+    compare_one(RCX);
+    std::size_t right_jump = jump(JUMP::IF_OVERFLOW);
+    //test rcx, rcx
+    byte(0x48);
+    byte(0x85);
+    byte(0xC9);
+    std::size_t zero_jump = jump(JUMP::IF_CLEAR);
+    //X MOD -1 is X MOD 1: cmp rcx, -1; mov ecx, 1
+    byte(0x48);
+    byte(0x83);
+    byte(0xF9);
+    byte(0xFF);
+    std::size_t divisor_jump = jump(JUMP::IF_SET);
+    byte(0xB9);
+    dword(1);
+    patch(divisor_jump,position());
+    //cqo; idiv rcx
+    byte(0x48);
+    byte(0x99);
+    byte(0x48);
+    byte(0xF7);
+    byte(0xF9);
+    sse(SCALAR,CVTSI2SD,left,RDX,true);
+    std::size_t done_jump = jump(JUMP::ALWAYS);
+    //Otherwise fmod(trunc(left), trunc(right)) with x87 fprem, the loop calls nothing so the red zone is free
+    patch(left_jump,position());
+    patch(right_jump,position());
+    patch(zero_jump,position());
+    sse_stack(MOVSD_STORE,left,-8);
+    sse_stack(MOVSD_STORE,right,-16);
+    //mov [rsp - 24], rax; mov [rsp - 32], rcx
+    byte(0x48);
+    byte(0x89);
+    stack_operand(RAX,-24);
+    byte(0x48);
+    byte(0x89);
+    stack_operand(RCX,-32);
+    load_whole(RCX,-32,-16);
+    load_whole(RAX,-24,-8);
+    //fprem; fnstsw ax; test ah, 4, until the reduction is complete
+    std::size_t reduce = position();
+    byte(0xD9);
+    byte(0xF8);
+    byte(0xDF);
+    byte(0xE0);
+    byte(0xF6);
+    byte(0xC4);
+    byte(0x04);
+    jump(JUMP::IF_SET,reduce);
+    //fstp qword [rsp - 8]; fstp st0
+    byte(0xDD);
+    stack_operand(3,-8);
+    byte(0xDD);
+    byte(0xD8);
+    sse_stack(MOVSD_LOAD,left,-8);
+    patch(done_jump,position());
+}
+void X86Assembler::compare_one(unsigned int gpr)
+{
+    byte(0x48);
+    byte(0x83);
+    byte(0xF8 | gpr);
+    byte(0x01);
+}
+void X86Assembler::stack_operand(unsigned int reg,std::int8_t displacement)
+{
+    //mod 01, rm 100, SIB rsp: [rsp + disp8]
+    byte(0x44 | ((reg & 7) << 3));
+    byte(0x24);
+    byte(static_cast<unsigned char>(displacement));
+}
+void X86Assembler::sse_stack(unsigned char opcode,unsigned int reg,std::int8_t displacement)
+{
+    byte(SCALAR);
+    rex(false,reg,0);
+    byte(0x0F);
+    byte(opcode);
+    stack_operand(reg,displacement);
+}
+void X86Assembler::load_whole(unsigned int gpr,std::int8_t integer_displacement,std::int8_t decimal_displacement)
+{
+    //fild qword the converted integer, or fld qword the decimal past 2^63
+    compare_one(gpr);
+    std::size_t decimal_jump = jump(JUMP::IF_OVERFLOW);
+    byte(0xDF);
+    stack_operand(5,integer_displacement);
+    std::size_t done_jump = jump(JUMP::ALWAYS);
+    patch(decimal_jump,position());
+    byte(0xDD);
+    stack_operand(0,decimal_displacement);
+    patch(done_jump,position());
+}
+void X86Assembler::test_mask(unsigned int reg)
+{
+    //movmskpd eax, reg; test al, 1
+    sse(PACKED,MOVMSKPD,RAX,reg);
+    byte(0xA8);
+    byte(0x01);
+}
+std::size_t X86Assembler::jump(JUMP condition)
+{
+    if(condition == JUMP::ALWAYS)
+    {
+        byte(0xE9);
+    }
+    else
+    {
+        byte(0x0F);
+        byte(condition == JUMP::IF_OVERFLOW ? 0x80 : condition == JUMP::IF_CLEAR ? 0x84 : 0x85);
+    }
+    dword(0);
+    return position() - 4;
+}
+void X86Assembler::jump(JUMP condition,std::size_t target)
+{
+    patch(jump(condition),target);
+}
+void X86Assembler::patch(std::size_t jump_position,std::size_t target)
+{
+    std::uint32_t offset = std::uint32_t(std::int32_t(target) - std::int32_t(jump_position + 4));
+    for(int i = 0; i < 4; ++i)
+    {
+        m_code[jump_position + i] = (offset >> (i * 8)) & 0xFF;
+    }
+}
+
+NativeLoop::NativeLoop(const std::vector<unsigned char> & code,const std::vector<variable_slot> & slots) : m_memory(nullptr), m_size(code.size()), m_entry(nullptr), m_slots(slots)
+{
+#if defined SBASIC_JIT
+    //Written while writable, then flipped to executable
+    void * memory = mmap(nullptr,m_size,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+    if(memory == MAP_FAILED)
+    {
+        return;
+    }
+    m_memory = memory;
+    std::memcpy(m_memory,code.data(),m_size);
+    if(mprotect(m_memory,m_size,PROT_READ | PROT_EXEC) == 0)
+    {
+        m_entry = reinterpret_cast<entry_point>(m_memory);
+    }
+#endif // defined
+}
+NativeLoop::~NativeLoop()
+{
+#if defined SBASIC_JIT
+    if(m_memory != nullptr)
+    {
+        munmap(m_memory,m_size);
+    }
+#endif // defined
+}
+
+//Builds without SBASIC_JIT leave every loop to the tree walker
+void LoopJit::install([[maybe_unused]] Program * program)
+{
+#if defined SBASIC_JIT
+    install(program->get_stmts(),program->get_arena());
+#endif // defined
+}
+void LoopJit::install(const NodeList<Stmt *> & stmts,Arena & arena)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        switch((**it).get_stmt_type())
+        {
+        case STMT::SELECTION_STMT:
+        {
+            SelectionStmt * selection_stmt_ptr = static_cast<SelectionStmt *>(*it);
+            install(selection_stmt_ptr->get_true_stmts(),arena);
+            install(selection_stmt_ptr->get_false_stmts(),arena);
+            break;
+        }
+        case STMT::BLOCK_STMT:
+            install(static_cast<BlockStmt *>(*it)->get_stmts(),arena);
+            break;
+        case STMT::WHILE_ITERATOR_STMT:
+        {
+            WHILEIteratorStmt * while_stmt_ptr = static_cast<WHILEIteratorStmt *>(*it);
+            install(while_stmt_ptr->get_stmts(),arena);
+            *it = arena.create<JitWHILEIteratorStmt>(*this,*while_stmt_ptr);
+            break;
+        }
+        case STMT::DO_ITERATOR_STMT:
+        {
+            DOIteratorStmt * do_stmt_ptr = static_cast<DOIteratorStmt *>(*it);
+            install(do_stmt_ptr->get_stmts(),arena);
+            *it = arena.create<JitDOIteratorStmt>(*this,*do_stmt_ptr);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+NativeLoop * LoopJit::compile(const Stmt * loop)
+{
+#if defined SBASIC_JIT
+    m_assembler = X86Assembler();
+    m_uses.clear();
+    m_registers.clear();
+    m_defined_variables.clear();
+    m_scope_variables.clear();
+    m_scopes.clear();
+    m_entry_slots.clear();
+    count(loop);
+    for(auto it = m_uses.begin(); it != m_uses.end(); ++it)
+    {
+        if(it->first > MAX_NATIVE_SLOT)
+        {
+            return nullptr;
+        }
+    }
+    std::vector<variable_slot> slots(m_entry_slots.begin(),m_entry_slots.end());
+    allocate_registers();
+    //void loop(double * variables), the variables in registers are loaded on entry and spilled on exit
+    //Loop-local slots are loaded too, a path that never writes one spills back what it held
+    for(auto it = m_registers.begin(); it != m_registers.end(); ++it)
+    {
+        m_assembler.sse_memory(SCALAR,MOVSD_LOAD,it->second,std::int32_t(it->first * sizeof(sbasic_decimal_type)));
+    }
+    if(!stmt(loop))
+    {
+        return nullptr;
+    }
+    for(auto it = m_registers.begin(); it != m_registers.end(); ++it)
+    {
+        m_assembler.sse_memory(SCALAR,MOVSD_STORE,it->second,std::int32_t(it->first * sizeof(sbasic_decimal_type)));
+    }
+    m_assembler.ret();
+    std::unique_ptr<NativeLoop> native_loop(new NativeLoop(m_assembler.get_code(),slots));
+    if(!native_loop->is_ready())
+    {
+        return nullptr;
+    }
+    m_native_loops.push_back(std::move(native_loop));
+    return m_native_loops.back().get();
+#else
+    (void)loop;
+    return nullptr;
+#endif // defined
+}
+
+void LoopJit::count(const NodeList<Stmt *> & stmts)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        count(*it);
+    }
+}
+//Counts the uses of every slot and finds the ones read before the loop writes them
+//Each iteration starts from the same definedness, its block forgets what it created, so one pass is enough
+void LoopJit::count(const Stmt * stmt)
+{
+    switch(stmt->get_stmt_type())
+    {
+    case STMT::ASSIGNMENT_STMT:
+    {
+        const AssignmentStmt * assignment_stmt_ptr = static_cast<const AssignmentStmt *>(stmt);
+        count(assignment_stmt_ptr->get_expression());
+        variable_slot slot = assignment_stmt_ptr->get_variable_expression()->get_slot();
+        ++m_uses[slot];
+        define(slot);
+        break;
+    }
+    case STMT::SELECTION_STMT:
+    {
+        const SelectionStmt * selection_stmt_ptr = static_cast<const SelectionStmt *>(stmt);
+        count(selection_stmt_ptr->get_condition());
+        enter_scope();
+        count(selection_stmt_ptr->get_true_stmts());
+        leave_scope();
+        enter_scope();
+        count(selection_stmt_ptr->get_false_stmts());
+        leave_scope();
+        break;
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        const WHILEIteratorStmt * while_stmt_ptr = static_cast<const WHILEIteratorStmt *>(stmt);
+        count(while_stmt_ptr->get_condition());
+        enter_scope();
+        count(while_stmt_ptr->get_stmts());
+        leave_scope();
+        break;
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        const DOIteratorStmt * do_stmt_ptr = static_cast<const DOIteratorStmt *>(stmt);
+        enter_scope();
+        count(do_stmt_ptr->get_stmts());
+        leave_scope();
+        count(do_stmt_ptr->get_condition());
+        break;
+    }
+    case STMT::BLOCK_STMT:
+        enter_scope();
+        count(static_cast<const BlockStmt *>(stmt)->get_stmts());
+        leave_scope();
+        break;
+    default:
+        //PRINT and INPUT are never compiled
+        break;
+    }
+}
+void LoopJit::count(const Expression * expression)
+{
+    //Right operands in a loop, see MAX_NESTED_OPERATORS
+    while(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        count(static_cast<const BinaryExpression *>(expression)->get_left_expression());
+        expression = static_cast<const BinaryExpression *>(expression)->get_right_expression();
+    }
+    switch(expression->get_expression_type())
+    {
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    {
+        variable_slot slot = static_cast<const VariableExpression *>(expression)->get_slot();
+        ++m_uses[slot];
+        if(!m_defined_variables.count(slot))
+        {
+            //Checked before the loop runs, then defined for the whole loop
+            m_entry_slots.insert(slot);
+            m_defined_variables.insert(slot);
+        }
+        break;
+    }
+    case EXPRESSION::UNARY_EXPRESSION:
+        count(static_cast<const UnaryExpression *>(expression)->get_expression());
+        break;
+    default:
+        break;
+    }
+}
+void LoopJit::define(variable_slot slot)
+{
+    //Assignment updates a slot defined outside the block, otherwise creates it in the block
+    if(m_defined_variables.insert(slot).second)
+    {
+        m_scope_variables.push_back(slot);
+    }
+}
+void LoopJit::enter_scope()
+{
+    m_scopes.push_back(m_scope_variables.size());
+}
+void LoopJit::leave_scope()
+{
+    for(std::size_t i = m_scopes.back(); i < m_scope_variables.size(); ++i)
+    {
+        m_defined_variables.erase(m_scope_variables[i]);
+    }
+    m_scope_variables.resize(m_scopes.back());
+    m_scopes.pop_back();
+}
+void LoopJit::allocate_registers()
+{
+    std::vector<std::pair<unsigned int,variable_slot>> uses;
+    for(auto it = m_uses.begin(); it != m_uses.end(); ++it)
+    {
+        uses.push_back(std::make_pair(it->second,it->first));
+    }
+    std::stable_sort(uses.begin(),uses.end(),[](const std::pair<unsigned int,variable_slot> & a,const std::pair<unsigned int,variable_slot> & b)
+    {
+        return a.first > b.first;
+    });
+    for(std::size_t i = 0; i < uses.size() && i < VARIABLE_REGISTERS; ++i)
+    {
+        m_registers[uses[i].second] = TEMPORARY_REGISTERS + i;
+    }
+}
+
+void LoopJit::load_variable(unsigned int reg,variable_slot slot)
+{
+    auto it = m_registers.find(slot);
+    if(it != m_registers.end())
+    {
+        m_assembler.sse(PACKED,MOVAPD,reg,it->second);
+    }
+    else
+    {
+        m_assembler.sse_memory(SCALAR,MOVSD_LOAD,reg,std::int32_t(slot * sizeof(sbasic_decimal_type)));
+    }
+}
+void LoopJit::store_variable(variable_slot slot,unsigned int reg)
+{
+    auto it = m_registers.find(slot);
+    if(it != m_registers.end())
+    {
+        m_assembler.sse(PACKED,MOVAPD,it->second,reg);
+    }
+    else
+    {
+        m_assembler.sse_memory(SCALAR,MOVSD_STORE,reg,std::int32_t(slot * sizeof(sbasic_decimal_type)));
+    }
+}
+
+bool LoopJit::stmts(const NodeList<Stmt *> & stmts)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        if(!stmt(*it))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+//Only the slots read before they are written are checked, native code never marks a slot defined
+//So what the loop creates is undefined after it, as the tree walker leaves it after every iteration
+bool LoopJit::stmt(const Stmt * stmt)
+{
+    switch(stmt->get_stmt_type())
+    {
+    case STMT::ASSIGNMENT_STMT:
+    {
+        const AssignmentStmt * assignment_stmt_ptr = static_cast<const AssignmentStmt *>(stmt);
+        if(!value(assignment_stmt_ptr->get_expression(),0))
+        {
+            return false;
+        }
+        store_variable(assignment_stmt_ptr->get_variable_expression()->get_slot(),0);
+        return true;
+    }
+    case STMT::SELECTION_STMT:
+    {
+        const SelectionStmt * selection_stmt_ptr = static_cast<const SelectionStmt *>(stmt);
+        if(!mask(selection_stmt_ptr->get_condition(),0))
+        {
+            return false;
+        }
+        m_assembler.test_mask(0);
+        std::size_t false_jump = m_assembler.jump(JUMP::IF_CLEAR);
+        if(!stmts(selection_stmt_ptr->get_true_stmts()))
+        {
+            return false;
+        }
+        if(selection_stmt_ptr->get_false_stmts().empty())
+        {
+            m_assembler.patch(false_jump,m_assembler.position());
+            return true;
+        }
+        std::size_t end_jump = m_assembler.jump(JUMP::ALWAYS);
+        m_assembler.patch(false_jump,m_assembler.position());
+        if(!stmts(selection_stmt_ptr->get_false_stmts()))
+        {
+            return false;
+        }
+        m_assembler.patch(end_jump,m_assembler.position());
+        return true;
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        const WHILEIteratorStmt * while_stmt_ptr = static_cast<const WHILEIteratorStmt *>(stmt);
+        std::size_t top = m_assembler.position();
+        if(!mask(while_stmt_ptr->get_condition(),0))
+        {
+            return false;
+        }
+        m_assembler.test_mask(0);
+        std::size_t exit_jump = m_assembler.jump(JUMP::IF_CLEAR);
+        if(!stmts(while_stmt_ptr->get_stmts()))
+        {
+            return false;
+        }
+        m_assembler.jump(JUMP::ALWAYS,top);
+        m_assembler.patch(exit_jump,m_assembler.position());
+        return true;
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        const DOIteratorStmt * do_stmt_ptr = static_cast<const DOIteratorStmt *>(stmt);
+        std::size_t top = m_assembler.position();
+        if(!stmts(do_stmt_ptr->get_stmts()))
+        {
+            return false;
+        }
+        const Expression * condition = do_stmt_ptr->get_condition();
+        if(condition->is_boolean())
+        {
+            if(!mask(condition,0))
+            {
+                return false;
+            }
+            m_assembler.test_mask(0);
+            m_assembler.jump(JUMP::IF_CLEAR,top);
+            return true;
+        }
+        //Repeats while the condition is sbasic_false
+        if(!value(condition,0))
+        {
+            return false;
+        }
+        m_assembler.load_constant(1,sbasic_false);
+        m_assembler.compare(0,1,COMPARE_EQUAL);
+        m_assembler.test_mask(0);
+        m_assembler.jump(JUMP::IF_SET,top);
+        return true;
+    }
+    case STMT::BLOCK_STMT:
+        return stmts(static_cast<const BlockStmt *>(stmt)->get_stmts());
+    default:
+        return false;
+    }
+}
+
+//Computes expression into reg, registers above reg are free to use
+bool LoopJit::value(const Expression * expression,unsigned int reg)
+{
+    if(reg + 1 >= TEMPORARY_REGISTERS)
+    {
+        return false;
+    }
+    switch(expression->get_expression_type())
+    {
+    case EXPRESSION::DECIMAL_EXPRESSION:
+    case EXPRESSION::VARIABLE_EXPRESSION:
+        leaf(expression,reg);
+        return true;
+    case EXPRESSION::UNARY_EXPRESSION:
+    {
+        const UnaryExpression * unary_exp_ptr = static_cast<const UnaryExpression *>(expression);
+        if(unary_exp_ptr->get_operator() == OPERATOR::PLUS)
+        {
+            return value(unary_exp_ptr->get_expression(),reg);
+        }
+        else if(unary_exp_ptr->get_operator() == OPERATOR::SUBSTRACT)
+        {
+            if(!value(unary_exp_ptr->get_expression(),reg))
+            {
+                return false;
+            }
+            //Flip the sign bit, so -0 stays distinct from 0
+            m_assembler.load_constant(reg + 1,-0.0);
+            m_assembler.sse(PACKED,XORPD,reg,reg + 1);
+            return true;
+        }
+        return mask(expression,reg) && boolean(reg);
+    }
+    case EXPRESSION::BINARY_EXPRESSION:
+    {
+        const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(expression);
+        OPERATOR op = binary_exp_ptr->get_operator();
+        if(binary_exp_ptr->get_chain_length() > MAX_NESTED_OPERATORS)
+        {
+            //Left to the tree walker, compiling it would nest as deep as the chain is long
+            return false;
+        }
+        if(is_comparison(op) || op == OPERATOR::AND || op == OPERATOR::OR)
+        {
+            return mask(expression,reg) && boolean(reg);
+        }
+        unsigned char opcode;
+        switch(op)
+        {
+        case OPERATOR::PLUS:
+            opcode = ADDSD;
+            break;
+        case OPERATOR::SUBSTRACT:
+            opcode = SUBSD;
+            break;
+        case OPERATOR::MULTIPLY:
+            opcode = MULSD;
+            break;
+        case OPERATOR::DIVIDE:
+        case OPERATOR::DIVIDE_EXACTLY:
+        case OPERATOR::MOD:
+            opcode = DIVSD;
+            break;
+        default:
+            return false;
+        }
+        unsigned int left;
+        unsigned int right;
+        if(!operands(binary_exp_ptr,reg,left,right,false))
+        {
+            return false;
+        }
+        if(op == OPERATOR::MOD)
+        {
+            m_assembler.remainder(left,right);
+        }
+        else
+        {
+            m_assembler.sse(SCALAR,opcode,left,right);
+        }
+        if(op == OPERATOR::DIVIDE_EXACTLY)
+        {
+            m_assembler.truncate(left);
+        }
+        if(left != reg)
+        {
+            m_assembler.sse(PACKED,MOVAPD,reg,left);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+void LoopJit::leaf(const Expression * expression,unsigned int reg)
+{
+    if(expression->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION)
+    {
+        m_assembler.load_constant(reg,static_cast<const DecimalExpression *>(expression)->get_decimal());
+    }
+    else
+    {
+        load_variable(reg,static_cast<const VariableExpression *>(expression)->get_slot());
+    }
+}
+//Puts both operands in registers at reg and above, left is always writable
+//Nothing compiled can fail or have side effects, so a deeper right side goes first and keeps fewer registers busy
+bool LoopJit::operands(const BinaryExpression * binary_expression,unsigned int reg,unsigned int & left,unsigned int & right,bool writable_right)
+{
+    const Expression * left_expression = binary_expression->get_left_expression();
+    const Expression * right_expression = binary_expression->get_right_expression();
+    if(is_leaf(left_expression) && !is_leaf(right_expression))
+    {
+        if(!value(right_expression,reg))
+        {
+            return false;
+        }
+        leaf(left_expression,reg + 1);
+        left = reg + 1;
+        right = reg;
+        return true;
+    }
+    if(!value(left_expression,reg))
+    {
+        return false;
+    }
+    left = reg;
+    right = reg + 1;
+    if(!writable_right && right_expression->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION)
+    {
+        //A variable kept in a register is read where it lives
+        auto it = m_registers.find(static_cast<const VariableExpression *>(right_expression)->get_slot());
+        if(it != m_registers.end())
+        {
+            right = it->second;
+            return true;
+        }
+    }
+    return value(right_expression,reg + 1);
+}
+
+//Leaves all ones in reg when the expression tests true, zero otherwise
+//AND and OR evaluate both sides for the same reason
+bool LoopJit::mask(const Expression * expression,unsigned int reg)
+{
+    if(reg + 1 >= TEMPORARY_REGISTERS)
+    {
+        return false;
+    }
+    if(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(expression);
+        OPERATOR op = binary_exp_ptr->get_operator();
+        if(binary_exp_ptr->get_chain_length() > MAX_NESTED_OPERATORS)
+        {
+            return false;
+        }
+        if(op == OPERATOR::AND || op == OPERATOR::OR)
+        {
+            if(!mask(binary_exp_ptr->get_left_expression(),reg) || !mask(binary_exp_ptr->get_right_expression(),reg + 1))
+            {
+                return false;
+            }
+            m_assembler.sse(PACKED,op == OPERATOR::AND ? ANDPD : ORPD,reg,reg + 1);
+            return true;
+        }
+        if(is_comparison(op))
+        {
+            //> and >= are < and <= with the operands swapped, the mask then lands in right
+            bool swapped = op == OPERATOR::GREATER_THEN || op == OPERATOR::GREATER_THEN_OR_EQUAL;
+            unsigned int left;
+            unsigned int right;
+            if(!operands(binary_exp_ptr,reg,left,right,swapped))
+            {
+                return false;
+            }
+            switch(op)
+            {
+            case OPERATOR::EQUAL:
+                m_assembler.compare(left,right,COMPARE_EQUAL);
+                break;
+            case OPERATOR::NOT_EQUAL:
+                m_assembler.compare(left,right,COMPARE_NOT_EQUAL);
+                break;
+            case OPERATOR::LESS_THEN:
+                m_assembler.compare(left,right,COMPARE_LESS);
+                break;
+            case OPERATOR::LESS_THEN_OR_EQUAL:
+                m_assembler.compare(left,right,COMPARE_LESS_OR_EQUAL);
+                break;
+            case OPERATOR::GREATER_THEN:
+                m_assembler.compare(right,left,COMPARE_LESS);
+                break;
+            default:
+                m_assembler.compare(right,left,COMPARE_LESS_OR_EQUAL);
+                break;
+            }
+            unsigned int result = swapped ? right : left;
+            if(result != reg)
+            {
+                m_assembler.sse(PACKED,MOVAPD,reg,result);
+            }
+            return true;
+        }
+    }
+    if(expression->get_expression_type() == EXPRESSION::UNARY_EXPRESSION && static_cast<const UnaryExpression *>(expression)->get_operator() == OPERATOR::NOT)
+    {
+        //NOT x tests x == sbasic_false, the same as flipping the test of a comparison
+        if(!value(static_cast<const UnaryExpression *>(expression)->get_expression(),reg))
+        {
+            return false;
+        }
+        m_assembler.load_constant(reg + 1,sbasic_false);
+        m_assembler.compare(reg,reg + 1,COMPARE_EQUAL);
+        return true;
+    }
+    if(!value(expression,reg))
+    {
+        return false;
+    }
+    m_assembler.load_constant(reg + 1,sbasic_true);
+    m_assembler.compare(reg,reg + 1,COMPARE_EQUAL);
+    return true;
+}
+//Turns the mask in reg into sbasic_true or sbasic_false
+bool LoopJit::boolean(unsigned int reg)
+{
+    m_assembler.load_constant(reg + 1,sbasic_true);
+    m_assembler.sse(PACKED,ANDPD,reg,reg + 1);
+    return true;
+}
+
+void JitWHILEIteratorStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
+{
+    bool native = m_native_loop != nullptr && m_native_loop->can_run(variable_table);
+    while(true)
+    {
+        if(native)
+        {
+            //Runs the rest of the loop, condition included
+            m_native_loop->run(variable_table);
+            return;
+        }
+        if(!get_condition()->test(function_table,variable_table))
+        {
+            return;
+        }
+        std::size_t block = variable_table->mark();
+        for(auto it = get_stmts().begin(); it != get_stmts().end(); ++it)
+        {
+            (**it).execute(function_table,variable_table);
+        }
+        variable_table->reset(block);
+        if(m_iterations < HOT_LOOP_ITERATIONS && ++m_iterations == HOT_LOOP_ITERATIONS)
+        {
+            m_native_loop = m_loop_jit.compile(this);
+            native = m_native_loop != nullptr && m_native_loop->can_run(variable_table);
+        }
+    }
+}
+void JitDOIteratorStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
+{
+    bool native = m_native_loop != nullptr && m_native_loop->can_run(variable_table);
+    do
+    {
+        if(native)
+        {
+            //Starts at the body, the same as entering the loop again
+            m_native_loop->run(variable_table);
+            return;
+        }
+        std::size_t block = variable_table->mark();
+        for(auto it = get_stmts().begin(); it != get_stmts().end(); ++it)
+        {
+            (**it).execute(function_table,variable_table);
+        }
+        variable_table->reset(block);
+        if(m_iterations < HOT_LOOP_ITERATIONS && ++m_iterations == HOT_LOOP_ITERATIONS)
+        {
+            m_native_loop = m_loop_jit.compile(this);
+            native = m_native_loop != nullptr && m_native_loop->can_run(variable_table);
+        }
+    }
+    while(get_condition()->is_boolean() ? !get_condition()->test(function_table,variable_table) : get_condition()->compute(function_table,variable_table) == sbasic_false);
+}
+}
+}
@@ -0,0 +1,182 @@
+#ifndef JIT_H_INCLUDED
+#define JIT_H_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include "language.h"
+
+//Native code needs double slots and the System V x86-64 calling convention
+#if defined(SBASIC_DECIMAL_TYPE_DOUBLE) && defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#define SBASIC_JIT
+#endif
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Iterations a loop runs in the tree walker before it is compiled
+const unsigned int HOT_LOOP_ITERATIONS = 1000;
+
+//Jump condition, after a mask test
+enum class JUMP
+{
+    ALWAYS, IF_CLEAR, IF_SET, IF_OVERFLOW
+};
+
+//X86Assembler, the few SSE2 scalar double instructions the loop compiler needs
+//xmm0 - xmm15 are registers 0 - 15, memory operands are [rdi + displacement]
+class X86Assembler
+{
+private:
+    std::vector<unsigned char> m_code;
+    void byte(unsigned char b)
+    {
+        m_code.push_back(b);
+    }
+    void dword(std::uint32_t d);
+    void rex(bool wide,unsigned int reg,unsigned int rm);
+    //cmp gpr, 1, overflows only on the 0x8000000000000000 cvttsd2si gives out of range
+    void compare_one(unsigned int gpr);
+    //[rsp + displacement], scratch memory in the red zone
+    void stack_operand(unsigned int reg,std::int8_t displacement);
+    void sse_stack(unsigned char opcode,unsigned int reg,std::int8_t displacement);
+    void load_whole(unsigned int gpr,std::int8_t integer_displacement,std::int8_t decimal_displacement);
+public:
+    const std::vector<unsigned char> & get_code() const
+    {
+        return m_code;
+    }
+    std::size_t position() const
+    {
+        return m_code.size();
+    }
+    //prefix 0F opcode reg, rm
+    void sse(unsigned char prefix,unsigned char opcode,unsigned int reg,unsigned int rm,bool wide = false);
+    //prefix 0F opcode reg, [rdi + displacement]
+    void sse_memory(unsigned char prefix,unsigned char opcode,unsigned int reg,std::int32_t displacement);
+    void compare(unsigned int reg,unsigned int rm,unsigned char predicate);
+    void load_constant(unsigned int reg,sbasic_decimal_type decimal);
+    void truncate(unsigned int reg);
+    void remainder(unsigned int left,unsigned int right);
+    void test_mask(unsigned int reg);
+    std::size_t jump(JUMP condition);
+    void jump(JUMP condition,std::size_t target);
+    void patch(std::size_t jump_position,std::size_t target);
+    void ret()
+    {
+        byte(0xC3);
+    }
+};
+
+//NativeLoop, one compiled loop in executable memory
+class NativeLoop
+{
+private:
+    typedef void (*entry_point)(sbasic_decimal_type * variables);
+    void * m_memory;
+    std::size_t m_size;
+    entry_point m_entry;
+    //Slots the loop reads before it writes them, they must be defined before it runs
+    std::vector<variable_slot> m_slots;
+public:
+    NativeLoop(const std::vector<unsigned char> & code,const std::vector<variable_slot> & slots);
+    NativeLoop(const NativeLoop &) = delete;
+    NativeLoop & operator=(const NativeLoop &) = delete;
+    ~NativeLoop();
+    bool is_ready() const
+    {
+        return m_entry != nullptr;
+    }
+    bool can_run(const VariableTable * variable_table) const
+    {
+        for(auto it = m_slots.begin(); it != m_slots.end(); ++it)
+        {
+            if(!variable_table->is_defined(*it))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    void run(VariableTable * variable_table)
+    {
+        m_entry(variable_table->get_variables());
+    }
+};
+
+//LoopJit, compiles hot loops made of assignments, arithmetic, comparisons and control flow
+//Anything else, PRINT, INPUT, calls and ^, leaves the loop to the tree walker
+class LoopJit
+{
+private:
+    std::vector<std::unique_ptr<NativeLoop>> m_native_loops;
+    X86Assembler m_assembler;
+    std::map<variable_slot,unsigned int> m_uses;
+    std::map<variable_slot,unsigned int> m_registers;
+    //Static definedness while counting, as in BytecodeCompiler, slots not yet written count as undefined
+    std::set<variable_slot> m_defined_variables;
+    std::vector<variable_slot> m_scope_variables;
+    std::vector<std::size_t> m_scopes;
+    std::set<variable_slot> m_entry_slots;
+    void install(const NodeList<Stmt *> & stmts,Arena & arena);
+    void count(const Stmt * stmt);
+    void count(const NodeList<Stmt *> & stmts);
+    void count(const Expression * expression);
+    void define(variable_slot slot);
+    void enter_scope();
+    void leave_scope();
+    void allocate_registers();
+    bool stmts(const NodeList<Stmt *> & stmts);
+    bool stmt(const Stmt * stmt);
+    bool is_leaf(const Expression * expression) const
+    {
+        return expression->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION || expression->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION;
+    }
+    void leaf(const Expression * expression,unsigned int reg);
+    bool value(const Expression * expression,unsigned int reg);
+    bool operands(const BinaryExpression * binary_expression,unsigned int reg,unsigned int & left,unsigned int & right,bool writable_right);
+    bool mask(const Expression * expression,unsigned int reg);
+    bool boolean(unsigned int reg);
+    void load_variable(unsigned int reg,variable_slot slot);
+    void store_variable(variable_slot slot,unsigned int reg);
+public:
+    //Replaces every loop of the program with one that compiles itself once hot
+    void install(Program * program);
+    NativeLoop * compile(const Stmt * loop);
+};
+
+//Loops that count their iterations and switch to native code once hot
+class JitWHILEIteratorStmt : public WHILEIteratorStmt
+{
+private:
+    LoopJit & m_loop_jit;
+    unsigned int m_iterations;
+    NativeLoop * m_native_loop;
+public:
+    JitWHILEIteratorStmt(LoopJit & loop_jit,const WHILEIteratorStmt & while_stmt) : m_loop_jit(loop_jit), m_iterations(0), m_native_loop(nullptr)
+    {
+        set_condition(while_stmt.get_condition());
+        set_stmts(while_stmt.get_stmts());
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
+};
+class JitDOIteratorStmt : public DOIteratorStmt
+{
+private:
+    LoopJit & m_loop_jit;
+    unsigned int m_iterations;
+    NativeLoop * m_native_loop;
+public:
+    JitDOIteratorStmt(LoopJit & loop_jit,const DOIteratorStmt & do_stmt) : m_loop_jit(loop_jit), m_iterations(0), m_native_loop(nullptr)
+    {
+        set_condition(do_stmt.get_condition());
+        set_stmts(do_stmt.get_stmts());
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
+};
+}
+}
+
+#endif // JIT_H_INCLUDED
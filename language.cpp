@@ -1,150 +1,215 @@
 #include "language.h"
+#include "output.h"
 #include <string>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <charconv>
 #include <iostream>
 
 namespace SBASIC
 {
+inline namespace SBASIC_NUMERIC
+{
 //Convert function
-sbasic_decimal_type string_to_decimal(const std::string & str)
+sbasic_decimal_type string_to_decimal(const char * begin,const char * end)
 {
+    //Correctly rounded, without copying the literal
+    sbasic_decimal_type decimal = 0;
+    std::from_chars_result result = std::from_chars(begin,end,decimal);
+    if(result.ec == std::errc::result_out_of_range)
+    {
+        //Overflow to infinity and underflow to zero like strtod
+        std::string str(begin,end);
 #if defined SBASIC_DECIMAL_TYPE_LONG_DOUBLE
-    return std::stold(str);
+        return std::strtold(str.c_str(),nullptr);
 #elif defined SBASIC_DECIMAL_TYPE_FLOAT
-    return std::stof(str);
+        return std::strtof(str.c_str(),nullptr);
 #elif defined SBASIC_DECIMAL_TYPE_DOUBLE
-    return std::stod(str);
+        return std::strtod(str.c_str(),nullptr);
 #endif // SBASIC_DECIMAL_TYPE_LONG_DOUBLE
+    }
+    return decimal;
 }
-KEYWORD string_to_keyword(const std::string & str)
+
+//Reserved words, found by a perfect hash of the first and last character
+const std::size_t RESERVED_WORD_TABLE_SIZE = 32;
+constexpr ReservedWord RESERVED_WORDS[] =
 {
-    if(str == "INPUT")
-    {
-        return KEYWORD::INPUT;
-    }
-    else if(str == "PRINT")
-    {
-        return KEYWORD::PRINT;
-    }
-    else if(str == "END")
-    {
-        return KEYWORD::END;
-    }
-    else if(str == "IF")
-    {
-        return KEYWORD::IF;
-    }
-    else if(str == "THEN")
-    {
-        return KEYWORD::THEN;
-    }
-    else if(str == "ELSE")
-    {
-        return KEYWORD::ELSE;
-    }
-    else if(str == "DO")
-    {
-        return KEYWORD::DO;
-    }
-    else if(str == "LOOP")
-    {
-        return KEYWORD::LOOP;
-    }
-    else if(str == "UNTIL")
-    {
-        return KEYWORD::UNTIL;
-    }
-    else if(str == "WHILE")
-    {
-        return KEYWORD::WHILE;
-    }
-    else
-    {
-        return KEYWORD::WEND;
-    }
+    {"INPUT",5,WORD::KEYWORD_WORD,KEYWORD::INPUT,OPERATOR::PLUS},
+    {"PRINT",5,WORD::KEYWORD_WORD,KEYWORD::PRINT,OPERATOR::PLUS},
+    {"END",3,WORD::KEYWORD_WORD,KEYWORD::END,OPERATOR::PLUS},
+    {"IF",2,WORD::KEYWORD_WORD,KEYWORD::IF,OPERATOR::PLUS},
+    {"THEN",4,WORD::KEYWORD_WORD,KEYWORD::THEN,OPERATOR::PLUS},
+    {"ELSE",4,WORD::KEYWORD_WORD,KEYWORD::ELSE,OPERATOR::PLUS},
+    {"DO",2,WORD::KEYWORD_WORD,KEYWORD::DO,OPERATOR::PLUS},
+    {"LOOP",4,WORD::KEYWORD_WORD,KEYWORD::LOOP,OPERATOR::PLUS},
+    {"UNTIL",5,WORD::KEYWORD_WORD,KEYWORD::UNTIL,OPERATOR::PLUS},
+    {"WHILE",5,WORD::KEYWORD_WORD,KEYWORD::WHILE,OPERATOR::PLUS},
+    {"WEND",4,WORD::KEYWORD_WORD,KEYWORD::WEND,OPERATOR::PLUS},
+    {"AND",3,WORD::LETTER_OPERATOR_WORD,KEYWORD::END,OPERATOR::AND},
+    {"OR",2,WORD::LETTER_OPERATOR_WORD,KEYWORD::END,OPERATOR::OR},
+    {"NOT",3,WORD::LETTER_OPERATOR_WORD,KEYWORD::END,OPERATOR::NOT},
+    {"MOD",3,WORD::LETTER_OPERATOR_WORD,KEYWORD::END,OPERATOR::MOD},
+    {"REM",3,WORD::COMMENT_WORD,KEYWORD::END,OPERATOR::PLUS}
+};
+const std::size_t RESERVED_WORD_COUNT = sizeof(RESERVED_WORDS) / sizeof(RESERVED_WORDS[0]);
+
+constexpr std::size_t reserved_word_hash(const char * str,std::size_t length)
+{
+    return (static_cast<unsigned char>(str[0]) + 5 * static_cast<unsigned char>(str[length - 1])) % RESERVED_WORD_TABLE_SIZE;
 }
-OPERATOR string_to_letter_operator(const std::string & str)
+
+//Slot to reserved word index plus one, 0 is empty
+struct ReservedWordTable
 {
-    if(str == "AND")
-    {
-        return OPERATOR::AND;
-    }
-    else if(str == "OR")
+    unsigned char m_indexes[RESERVED_WORD_TABLE_SIZE];
+    bool m_perfect;
+};
+
+constexpr ReservedWordTable create_reserved_word_table()
+{
+    ReservedWordTable table = {{},true};
+    for(std::size_t i = 0; i < RESERVED_WORD_COUNT; ++i)
     {
-        return OPERATOR::OR;
+        std::size_t slot = reserved_word_hash(RESERVED_WORDS[i].text,RESERVED_WORDS[i].length);
+        if(table.m_indexes[slot] != 0)
+        {
+            table.m_perfect = false;
+        }
+        table.m_indexes[slot] = static_cast<unsigned char>(i + 1);
     }
-    else if(str == "NOT")
+    return table;
+}
+
+constexpr ReservedWordTable RESERVED_WORD_TABLE = create_reserved_word_table();
+//Adding a reserved word may need a new multiplier in reserved_word_hash
+static_assert(RESERVED_WORD_TABLE.m_perfect,"Reserved word hash has a collision");
+
+//Find function
+const ReservedWord * find_reserved_word(const char * str,std::size_t length)
+{
+    unsigned char index = RESERVED_WORD_TABLE.m_indexes[reserved_word_hash(str,length)];
+    if(index == 0)
     {
-        return OPERATOR::NOT;
+        return nullptr;
     }
-    else
+    const ReservedWord * reserved_word = &RESERVED_WORDS[index - 1];
+    if(reserved_word->length == length && std::memcmp(reserved_word->text,str,length) == 0)
     {
-        return OPERATOR::MOD;
+        return reserved_word;
     }
+    return nullptr;
 }
 
 //Is function
-bool is_keyword(const std::string & str)
+bool is_prefix_operator(char c)
+{
+    return c == '+' || c == '-' || c == '*' || c == '/' || c == '\\' || c == '%' || c == '^' || c == '=' || c == '<' || c == '>';
+}
+bool is_delimiter(char c)
 {
-    return str == "INPUT" || str == "PRINT" || str == "END" || str == "IF" || str == "THEN" || str == "ELSE" || str == "DO" || str == "LOOP" || str == "UNTIL"|| str == "WHILE" || str == "WEND";
+    return c == '\n' || c == ';' || c == ',' || c == '(' || c == ')';
 }
 
-bool is_letter_operator(const std::string & str)
+//Standard functions
+static sbasic_decimal_type sbasic_abs(sbasic_decimal_type x)
 {
-    return str == "AND" || str == "OR" || str == "NOT" || str == "MOD";
+    return std::abs(x);
 }
-bool is_prefix_operator(char c)
+static sbasic_decimal_type sbasic_int(sbasic_decimal_type x)
 {
-    return c == '+' || c == '-' || c == '*' || c == '/' || c == '\\' || c == '%' || c == '^' || c == '=' || c == '<' || c == '>';
+    return std::floor(x);
 }
-bool is_delimiter(char c)
+static sbasic_decimal_type sbasic_sqr(sbasic_decimal_type x)
 {
-    return c == '\n' || c == ';' || c == ',' || c == '(' || c == ')';
+    return std::sqrt(x);
+}
+static sbasic_decimal_type sbasic_sin(sbasic_decimal_type x)
+{
+    return std::sin(x);
+}
+static sbasic_decimal_type sbasic_cos(sbasic_decimal_type x)
+{
+    return std::cos(x);
+}
+static sbasic_decimal_type sbasic_tan(sbasic_decimal_type x)
+{
+    return std::tan(x);
+}
+static sbasic_decimal_type sbasic_atn(sbasic_decimal_type x)
+{
+    return std::atan(x);
+}
+static sbasic_decimal_type sbasic_log(sbasic_decimal_type x)
+{
+    return std::log(x);
+}
+static sbasic_decimal_type sbasic_exp(sbasic_decimal_type x)
+{
+    return std::exp(x);
 }
+constexpr Function STANDARD_FUNCTIONS[] =
+{
+    native_function<sbasic_abs>("ABS","std::abs"),
+    native_function<sbasic_sgn<sbasic_decimal_type>>("SGN","sbasic_sgn"),
+    native_function<sbasic_int>("INT","std::floor"),
+    native_function<sbasic_sqr>("SQR","std::sqrt"),
+    native_function<sbasic_sin>("SIN","std::sin"),
+    native_function<sbasic_cos>("COS","std::cos"),
+    native_function<sbasic_tan>("TAN","std::tan"),
+    native_function<sbasic_atn>("ATN","std::atan"),
+    native_function<sbasic_log>("LOG","std::log"),
+    native_function<sbasic_exp>("EXP","std::exp"),
+    native_function<sbasic_rnd<sbasic_decimal_type>>("RND","sbasic_rnd")
+};
 
 //Table class
-sbasic_decimal_type VariableTable::get_variable(const std::string & variable_name) throw(std::string)
+FunctionTable::FunctionTable()
 {
-    for(VariableTable * variable_table_ptr = this; variable_table_ptr != nullptr; variable_table_ptr = (variable_table_ptr->m_previous_variable_table_ptr))
+    //Init standard functions
+    for(const Function & function : STANDARD_FUNCTIONS)
     {
-        if(variable_table_ptr->m_variables.count(variable_name))
-        {
-            return variable_table_ptr->m_variables[variable_name];
-        }
+        register_function(function);
     }
-    throw "The \"" + variable_name + "\" variable not found";
 }
 
-void VariableTable::assign_variable(const std::string & var_name, sbasic_decimal_type sdt)
+void FunctionTable::register_function(const Function & function)
 {
-    for(VariableTable * variable_table_ptr = this; variable_table_ptr != nullptr; variable_table_ptr = (variable_table_ptr->m_previous_variable_table_ptr))
+    //The entry names itself with its key, the caller's string may not live as long
+    auto it = m_functions.insert_or_assign(function.name,function).first;
+    it->second.name = it->first.c_str();
+}
+
+void FunctionTable::register_plugin(const sbasic_plugin & plugin,const std::string & file_name)
+{
+    for(std::size_t i = 0; i < plugin.function_count; ++i)
     {
-        if(variable_table_ptr->m_variables.count(var_name))
+        const sbasic_plugin_function & function = plugin.functions[i];
+#if defined SBASIC_DECIMAL_TYPE_LONG_DOUBLE
+        sbasic_function_pointer pointer = function.long_double_pointer;
+#elif defined SBASIC_DECIMAL_TYPE_FLOAT
+        sbasic_function_pointer pointer = function.float_pointer;
+#elif defined SBASIC_DECIMAL_TYPE_DOUBLE
+        sbasic_function_pointer pointer = function.double_pointer;
+#endif // SBASIC_DECIMAL_TYPE_LONG_DOUBLE
+        if(function.name == nullptr || pointer == nullptr || function.arity > MAX_FUNCTION_ARITY)
         {
-            variable_table_ptr->m_variables[var_name] = sdt;
-            return;
+            throw "The plugin \"" + file_name + "\" has a bad function";
         }
+        //Plugin functions have no C++ name, a program calling one can not be transpiled
+        register_function(Function{function.name,function.arity,pointer,nullptr});
     }
-    m_variables[var_name] = sdt;
 }
 
-FunctionTable::FunctionTable()
-{
-    //Init standard functions
-
-}
-
-sbasic_function_pointer FunctionTable::get_function(const std::string & function_name) throw(std::string)
+const Function * FunctionTable::find_function(const std::string & function_name) const
 {
-    if(m_functions.count(function_name))
-    {
-        return m_functions[function_name];
-    }
-    throw "The \"" + function_name + "\" function not found";
+    auto it = m_functions.find(function_name);
+    return it != m_functions.end() ? &it->second : nullptr;
 }
 
 //Program class
-sbasic_decimal_type UnaryExpression::compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+sbasic_decimal_type UnaryExpression::compute(FunctionTable & function_table,VariableTable * variable_table)
 {
     if(get_operator() == OPERATOR::PLUS)
     {
@@ -166,13 +231,26 @@ sbasic_decimal_type UnaryExpression::compute(FunctionTable & function_table,Vari
         }
     }
 }
+bool UnaryExpression::test(FunctionTable & function_table,VariableTable * variable_table)
+{
+    if(m_operator == OPERATOR::NOT)
+    {
+        //NOT of a comparison flips its test, anything else is compared with sbasic_false
+        if(m_expression->is_boolean())
+        {
+            return !m_expression->test(function_table,variable_table);
+        }
+        return m_expression->compute(function_table,variable_table) == sbasic_false;
+    }
+    return compute(function_table,variable_table) == sbasic_true;
+}
 
-sbasic_decimal_type VariableExpression::compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void VariableExpression::throw_not_found() const
 {
-    return variable_table->get_variable(m_var_name);
+    throw "Line: " + std::to_string(m_line_number) + ", Error: The \"" + m_var_name + "\" variable not found";
 }
 
-sbasic_decimal_type BinaryExpression::compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+sbasic_decimal_type BinaryExpression::compute(FunctionTable & function_table,VariableTable * variable_table)
 {
     if(m_operator == OPERATOR::PLUS)
     {
@@ -192,7 +270,8 @@ sbasic_decimal_type BinaryExpression::compute(FunctionTable & function_table,Var
     }
     else if(m_operator == OPERATOR::DIVIDE_EXACTLY)
     {
-        return int(m_left_expression->compute(function_table,variable_table) / m_right_expression->compute(function_table,variable_table));
+        sbasic_decimal_type left = m_left_expression->compute(function_table,variable_table);
+        return sbasic_divide_exactly(left,m_right_expression->compute(function_table,variable_table));
     }
     else if(m_operator == OPERATOR::POWER)
     {
@@ -200,125 +279,161 @@ sbasic_decimal_type BinaryExpression::compute(FunctionTable & function_table,Var
     }
     else if(m_operator == OPERATOR::MOD)
     {
-        return int(m_left_expression->compute(function_table,variable_table)) % int(m_right_expression->compute(function_table,variable_table));
-    }
-    else if(m_operator == OPERATOR::EQUAL)
-    {
-        return m_left_expression->compute(function_table,variable_table) == m_right_expression->compute(function_table,variable_table) ? sbasic_true : sbasic_false;
-    }
-    else if(m_operator == OPERATOR::GREATER_THEN)
-    {
-        return m_left_expression->compute(function_table,variable_table) > m_right_expression->compute(function_table,variable_table) ? sbasic_true : sbasic_false;
-    }
-    else if(m_operator == OPERATOR::GREATER_THEN_OR_EQUAL)
-    {
-        return m_left_expression->compute(function_table,variable_table) >= m_right_expression->compute(function_table,variable_table) ? sbasic_true : sbasic_false;
-    }
-    else if(m_operator == OPERATOR::LESS_THEN)
-    {
-        return m_left_expression->compute(function_table,variable_table) < m_right_expression->compute(function_table,variable_table) ? sbasic_true : sbasic_false;
+        sbasic_decimal_type left = m_left_expression->compute(function_table,variable_table);
+        return sbasic_mod(left,m_right_expression->compute(function_table,variable_table));
     }
-    else if(m_operator == OPERATOR::LESS_THEN_OR_EQUAL)
-    {
-        return m_left_expression->compute(function_table,variable_table) <= m_right_expression->compute(function_table,variable_table) ? sbasic_true : sbasic_false;
-    }
-    else if(m_operator == OPERATOR::NOT_EQUAL)
+    else
     {
-        return m_left_expression->compute(function_table,variable_table) != m_right_expression->compute(function_table,variable_table) ? sbasic_true : sbasic_false;
+        //Comparisons and logic operators
+        return test(function_table,variable_table) ? sbasic_true : sbasic_false;
     }
-    else if(m_operator == OPERATOR::AND)
-    {
-        return (m_left_expression->compute(function_table,variable_table)==sbasic_true) && (m_right_expression->compute(function_table,variable_table)==sbasic_true) ? sbasic_true : sbasic_false;
+}
+bool BinaryExpression::test(FunctionTable & function_table,VariableTable * variable_table)
+{
+    //Branch on the comparison itself, AND and OR skip the right side once the left decides
+    switch(m_operator)
+    {
+    case OPERATOR::EQUAL:
+        return m_left_expression->compute(function_table,variable_table) == m_right_expression->compute(function_table,variable_table);
+    case OPERATOR::GREATER_THEN:
+        return m_left_expression->compute(function_table,variable_table) > m_right_expression->compute(function_table,variable_table);
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+        return m_left_expression->compute(function_table,variable_table) >= m_right_expression->compute(function_table,variable_table);
+    case OPERATOR::LESS_THEN:
+        return m_left_expression->compute(function_table,variable_table) < m_right_expression->compute(function_table,variable_table);
+    case OPERATOR::LESS_THEN_OR_EQUAL:
+        return m_left_expression->compute(function_table,variable_table) <= m_right_expression->compute(function_table,variable_table);
+    case OPERATOR::NOT_EQUAL:
+        return m_left_expression->compute(function_table,variable_table) != m_right_expression->compute(function_table,variable_table);
+    case OPERATOR::AND:
+        return m_left_expression->test(function_table,variable_table) && m_right_expression->test(function_table,variable_table);
+    case OPERATOR::OR:
+        return m_left_expression->test(function_table,variable_table) || m_right_expression->test(function_table,variable_table);
+    default:
+        return compute(function_table,variable_table) == sbasic_true;
     }
-    else
-    {
-        return (m_left_expression->compute(function_table,variable_table)==sbasic_true) || (m_right_expression->compute(function_table,variable_table)==sbasic_true) ? sbasic_true : sbasic_false;
+}
+bool BinaryExpression::is_boolean() const
+{
+    switch(m_operator)
+    {
+    case OPERATOR::EQUAL:
+    case OPERATOR::GREATER_THEN:
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+    case OPERATOR::LESS_THEN:
+    case OPERATOR::LESS_THEN_OR_EQUAL:
+    case OPERATOR::NOT_EQUAL:
+    case OPERATOR::AND:
+    case OPERATOR::OR:
+        return true;
+    default:
+        return false;
     }
 }
-sbasic_decimal_type CallExpression::compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+sbasic_decimal_type CallExpression::compute(FunctionTable & function_table,VariableTable * variable_table)
 {
-    std::vector<sbasic_decimal_type> args;
-    for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
+    if(m_function == nullptr)
+    {
+        //The arguments still run first, their errors come before this one
+        for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
+        {
+            (**it).compute(function_table,variable_table);
+        }
+        throw "The \"" + std::string(m_function_name) + "\" function not found";
+    }
+    //The arity was checked when the call was bound
+    sbasic_decimal_type args[MAX_FUNCTION_ARITY];
+    for(std::size_t i = 0; i < m_expressions.size(); ++i)
     {
-        args.push_back((**it).compute(function_table,variable_table));
+        args[i] = m_expressions[i]->compute(function_table,variable_table);
     }
-    return function_table.get_function(m_function_name)(args);
+    return m_function->pointer(args);
 }
 
-void PrintStmt::execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void PrintStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
 {
-    if(has_prompt)
+    if(m_has_prompt)
     {
-        std::cout << m_prompt << std::endl;
+        standard_output.write(m_prompt);
+        standard_output.end_line();
     }
     for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
     {
-        std::cout << (**it).compute(function_table,variable_table) << std::endl;
+        standard_output.write_number((**it).compute(function_table,variable_table));
+        standard_output.end_line();
     }
 }
-void InputStmt::execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void InputStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
 {
-    if(has_prompt)
+    if(m_has_prompt)
     {
-        std::cout << m_prompt << "?";
-    }
-    else
-    {
-        std::cout << "?";
+        standard_output.write(m_prompt);
     }
+    standard_output.write("?",1);
+    standard_output.before_input();
     for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
     {
         sbasic_decimal_type sdt;
         std::cin >> sdt;
-        variable_table->assign_variable((**it).get_variable_name(),sdt);
+        variable_table->assign_variable((**it).get_slot(),sdt);
     }
 }
-void AssignmentStmt::execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void AssignmentStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
 {
-    variable_table->assign_variable(m_variable_expression->get_variable_name(),m_expression->compute(function_table,variable_table));
+    variable_table->assign_variable(m_variable_expression->get_slot(),m_expression->compute(function_table,variable_table));
 }
-void DOIteratorStmt::execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void DOIteratorStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
 {
     do
     {
-        VariableTable * var_tb = new VariableTable(variable_table);
+        std::size_t block = variable_table->mark();
         for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
         {
-            (**it).execute(function_table,var_tb);
+            (**it).execute(function_table,variable_table);
         }
-        delete var_tb;
+        variable_table->reset(block);
     }
-    while(m_condition->compute(function_table,variable_table) == sbasic_false);
+    while(m_condition->is_boolean() ? !m_condition->test(function_table,variable_table) : m_condition->compute(function_table,variable_table) == sbasic_false);
 }
-void SelectionStmt::execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void SelectionStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
 {
-    VariableTable * var_tb = new VariableTable(variable_table);
-    if(m_condition->compute(function_table,variable_table) == sbasic_true)
+    std::size_t block = variable_table->mark();
+    if(m_condition->test(function_table,variable_table))
     {
         for(auto it =  m_true_stmts.begin() ; it != m_true_stmts.end() ; ++it)
         {
-            (**it).execute(function_table,var_tb);
+            (**it).execute(function_table,variable_table);
         }
     }
     else
     {
         for(auto it =  m_false_stmts.begin() ; it != m_false_stmts.end() ; ++it)
         {
-            (**it).execute(function_table,var_tb);
+            (**it).execute(function_table,variable_table);
         }
     }
-    delete var_tb;
+    variable_table->reset(block);
 }
-void WHILEIteratorStmt::execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+void WHILEIteratorStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
 {
-    while(m_condition->compute(function_table,variable_table) == sbasic_true)
+    while(m_condition->test(function_table,variable_table))
     {
-        VariableTable * var_tb = new VariableTable(variable_table);
+        std::size_t block = variable_table->mark();
         for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
         {
-            (**it).execute(function_table,var_tb);
+            (**it).execute(function_table,variable_table);
         }
-        delete var_tb;
+        variable_table->reset(block);
     }
 }
+void BlockStmt::execute(FunctionTable & function_table,VariableTable * variable_table)
+{
+    std::size_t block = variable_table->mark();
+    for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
+    {
+        (**it).execute(function_table,variable_table);
+    }
+    variable_table->reset(block);
+}
+}
 }
@@ -1,15 +1,34 @@
 #ifndef LANGUAGE_H_INCLUDED
 #define LANGUAGE_H_INCLUDED
 
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
+#include "arena.h"
+#include "plugin.h"
+#include "runtime.h"
 
+//The core is built once per decimal type, each in a namespace of its own, double unless the build picks another
+#if !defined(SBASIC_DECIMAL_TYPE_LONG_DOUBLE) && !defined(SBASIC_DECIMAL_TYPE_FLOAT) && !defined(SBASIC_DECIMAL_TYPE_DOUBLE)
 #define SBASIC_DECIMAL_TYPE_DOUBLE
+#endif
+#if defined SBASIC_DECIMAL_TYPE_LONG_DOUBLE
+#define SBASIC_NUMERIC numeric_long_double
+#elif defined SBASIC_DECIMAL_TYPE_FLOAT
+#define SBASIC_NUMERIC numeric_float
+#elif defined SBASIC_DECIMAL_TYPE_DOUBLE
+#define SBASIC_NUMERIC numeric_double
+#endif // SBASIC_DECIMAL_TYPE_LONG_DOUBLE
 namespace SBASIC
 {
+inline namespace SBASIC_NUMERIC
+{
 //Type line_number
 typedef unsigned int line_number;
+//Type variable_slot
+typedef unsigned int variable_slot;
 
 //Enum
 enum class TOKEN
@@ -28,6 +47,22 @@ enum class OPERATOR
 {
     PLUS, SUBSTRACT, MULTIPLY, DIVIDE, DIVIDE_EXACTLY, POWER, MOD, EQUAL, GREATER_THEN, LESS_THEN, NOT_EQUAL, GREATER_THEN_OR_EQUAL, LESS_THEN_OR_EQUAL, AND, OR, NOT
 };
+enum class ASSOCIATIVITY
+{
+    LEFT, RIGHT
+};
+enum class WORD
+{
+    KEYWORD_WORD, LETTER_OPERATOR_WORD, COMMENT_WORD
+};
+enum class EXPRESSION
+{
+    UNARY_EXPRESSION, VARIABLE_EXPRESSION, BINARY_EXPRESSION, CALL_EXPRESSION, DECIMAL_EXPRESSION
+};
+enum class STMT
+{
+    PRINT_STMT, INPUT_STMT, ASSIGNMENT_STMT, DO_ITERATOR_STMT, SELECTION_STMT, WHILE_ITERATOR_STMT, BLOCK_STMT
+};
 
 //SBASIC decimal type
 #if defined SBASIC_DECIMAL_TYPE_LONG_DOUBLE
@@ -38,21 +73,49 @@ typedef float sbasic_decimal_type;
 typedef double sbasic_decimal_type;
 #endif // SBASIC_DECIMAL_TYPE_LONG_DOUBLE
 
-//SBASIC function pointer
-typedef sbasic_decimal_type (*sbasic_function_pointer)(const std::vector<sbasic_decimal_type> & args);
+//SBASIC function pointer, the arguments are an array as long as the function's arity
+typedef sbasic_decimal_type (*sbasic_function_pointer)(const sbasic_decimal_type * args);
+
+//Function, calls are bound to one when they are parsed
+struct Function
+{
+    const char * name;
+    std::size_t arity;
+    sbasic_function_pointer pointer;
+    //What generated C++ calls instead, nullptr when there is none
+    const char * cpp_name;
+};
+
+//The Function of a native function, its arity deduced from the C++ signature
+//Overloads need a cast to pick one: native_function<static_cast<double (*)(double,double)>(std::hypot)>("HYPOT")
+template<auto F>
+constexpr Function native_function(const char * name,const char * cpp_name = nullptr)
+{
+    typedef FunctionThunk<sbasic_decimal_type,decltype(F)> Thunk;
+    return Function{name,Thunk::arity,&Thunk::template call<F>,cpp_name};
+}
 
 //True or False
 const sbasic_decimal_type sbasic_true = 1;
 const sbasic_decimal_type sbasic_false = 0;
 
+//Reserved word
+struct ReservedWord
+{
+    const char * text;
+    std::size_t length;
+    WORD word_type;
+    KEYWORD keyword;
+    OPERATOR letter_operator;
+};
+
 //Convert function
-sbasic_decimal_type string_to_decimal(const std::string & str);
-KEYWORD string_to_keyword(const std::string & str);
-OPERATOR string_to_letter_operator(const std::string & str);
+sbasic_decimal_type string_to_decimal(const char * begin,const char * end);
+
+//Find function, nullptr for identifiers
+const ReservedWord * find_reserved_word(const char * str,std::size_t length);
 
 //Is function
-bool is_keyword(const std::string & str);
-bool is_letter_operator(const std::string & str);
 bool is_prefix_operator(char c);
 bool is_delimiter(char c);
 
@@ -60,33 +123,98 @@ bool is_delimiter(char c);
 class VariableTable
 {
 private:
-    std::map<std::string,sbasic_decimal_type> m_variables;
-    VariableTable * m_previous_variable_table_ptr;
+    std::vector<sbasic_decimal_type> m_variables;
+    std::vector<char> m_defined;
+    //Slots in creation order, a block owns the ones created after its mark
+    std::vector<variable_slot> m_created_slots;
 public:
-    VariableTable(VariableTable * previous_variable_table_ptr) : m_previous_variable_table_ptr(previous_variable_table_ptr) {}
-    sbasic_decimal_type get_variable(const std::string & variable_name) throw(std::string);
-    void assign_variable(const std::string & var_name, sbasic_decimal_type sdt);
-
+    VariableTable(std::size_t variable_count) : m_variables(variable_count), m_defined(variable_count)
+    {
+        //A slot is logged at most once while defined, so this never grows
+        m_created_slots.reserve(variable_count);
+    }
+    std::size_t mark() const
+    {
+        return m_created_slots.size();
+    }
+    void reset(std::size_t mark)
+    {
+        while(m_created_slots.size() > mark)
+        {
+            m_defined[m_created_slots.back()] = false;
+            m_created_slots.pop_back();
+        }
+    }
+    bool is_defined(variable_slot slot) const
+    {
+        return m_defined[slot];
+    }
+    sbasic_decimal_type get_variable(variable_slot slot) const
+    {
+        return m_variables[slot];
+    }
+    //Raw slots for native code, valid while the table lives
+    sbasic_decimal_type * get_variables()
+    {
+        return m_variables.data();
+    }
+    void assign_variable(variable_slot slot, sbasic_decimal_type sdt)
+    {
+        if(!m_defined[slot])
+        {
+            //Created in the current block
+            m_defined[slot] = true;
+            m_created_slots.push_back(slot);
+        }
+        m_variables[slot] = sdt;
+    }
 };
 
 class FunctionTable
 {
 private:
-    std::map<std::string,sbasic_function_pointer> m_functions;
+    //Entries never move, bound calls point into the table while it lives
+    std::map<std::string,Function> m_functions;
 public:
     FunctionTable();
-    sbasic_function_pointer get_function(const std::string & function_name) throw(std::string);
+    //Replaces a function of the same name, calls parsed afterwards are bound to the new one
+    void register_function(const Function & function);
+    //The functions of a loaded plugin, file_name is for errors
+    void register_plugin(const sbasic_plugin & plugin,const std::string & file_name);
+    //register_function<&hypot>("HYPOT")
+    template<auto F>
+    void register_function(const char * name,const char * cpp_name = nullptr)
+    {
+        register_function(native_function<F>(name,cpp_name));
+    }
+    bool has_function(const std::string & function_name) const
+    {
+        return m_functions.count(function_name) != 0;
+    }
+    //nullptr for unknown functions, calling one is an error at run time
+    const Function * find_function(const std::string & function_name) const;
 };
 
 //Program class
 class Expression
 {
 public:
-    virtual sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string) =0;
+    virtual sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) =0;
+    //Condition, compute() == sbasic_true without building the value where possible
+    virtual bool test(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return compute(function_table,variable_table) == sbasic_true;
+    }
+    //Whether compute() only ever gives sbasic_true or sbasic_false
+    virtual bool is_boolean() const
+    {
+        return false;
+    }
+    virtual EXPRESSION get_expression_type() const =0;
     virtual ~Expression() {}
 };
 
-class TailExpression
+class UnaryExpression : public Expression
 {
 private:
     OPERATOR m_operator;
@@ -108,28 +236,43 @@ public:
     {
         m_expression = expression;
     }
-};
-
-class UnaryExpression : public Expression, public TailExpression
-{
-    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    EXPRESSION get_expression_type() const
+    {
+        return EXPRESSION::UNARY_EXPRESSION;
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table);
+    bool test(FunctionTable & function_table,VariableTable * variable_table);
+    bool is_boolean() const
+    {
+        return m_operator == OPERATOR::NOT;
+    }
 };
 
 class VariableExpression : public Expression
 {
 private:
-    std::string m_var_name;
+    const char * m_var_name;
     line_number m_line_number;
+    variable_slot m_slot;
 public:
+    VariableExpression() : m_var_name(""), m_line_number(0), m_slot(0) {}
     std::string get_variable_name() const
     {
         return m_var_name;
     }
+    variable_slot get_slot() const
+    {
+        return m_slot;
+    }
+    void set_slot(variable_slot slot)
+    {
+        m_slot = slot;
+    }
     line_number get_line_number() const
     {
         return m_line_number;
     }
-    void set_variable_name(const std::string & variable_name)
+    void set_variable_name(const char * variable_name)
     {
         m_var_name = variable_name;
     }
@@ -137,21 +280,35 @@ public:
     {
         m_line_number = ln;
     }
-    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    EXPRESSION get_expression_type() const
+    {
+        return EXPRESSION::VARIABLE_EXPRESSION;
+    }
+    //Inline, so specialized nodes can read a variable without a virtual call
+    sbasic_decimal_type compute(FunctionTable &,VariableTable * variable_table)
+    {
+        if(!variable_table->is_defined(m_slot))
+        {
+            throw_not_found();
+        }
+        return variable_table->get_variable(m_slot);
+    }
+    [[noreturn]] void throw_not_found() const;
 };
 
+//Chains like 1 + 1 + 1 nest their right operands as deep as they are long
+//Passes walk the right operands in a loop, past this many operators engines compute a chain in one loop too
+const std::size_t MAX_NESTED_OPERATORS = 64;
+
 class BinaryExpression : public Expression
 {
 private:
     OPERATOR m_operator;
     Expression * m_left_expression;
     Expression * m_right_expression;
+    std::size_t m_chain_length;
 public:
-    ~BinaryExpression()
-    {
-        delete m_left_expression;
-        delete m_right_expression;
-    }
+    BinaryExpression() : m_chain_length(1) {}
     OPERATOR get_operator() const
     {
         return m_operator;
@@ -175,26 +332,50 @@ public:
     void set_right_expression(Expression * expression)
     {
         m_right_expression = expression;
+        m_chain_length = 1;
+        if(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+        {
+            m_chain_length += static_cast<const BinaryExpression *>(expression)->m_chain_length;
+        }
+    }
+    //Operators from here down the right operands, this one included
+    std::size_t get_chain_length() const
+    {
+        return m_chain_length;
     }
-    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    EXPRESSION get_expression_type() const
+    {
+        return EXPRESSION::BINARY_EXPRESSION;
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table);
+    bool test(FunctionTable & function_table,VariableTable * variable_table);
+    bool is_boolean() const;
 };
 class CallExpression : public Expression
 {
 private:
-    std::string m_function_name;
-    std::vector<Expression *> m_expressions;
+    const char * m_function_name;
+    NodeList<Expression *> m_expressions;
     line_number m_line_number;
+    const Function * m_function;
 public:
-    ~CallExpression()
+    CallExpression() : m_function_name(""), m_line_number(0), m_function(nullptr) {}
+    //nullptr when the function is unknown
+    const Function * get_function() const
     {
-        for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
-        {
-            delete (*it);
-        }
+        return m_function;
     }
-    void add_expression(Expression * expression)
+    void set_function(const Function * function)
     {
-        m_expressions.push_back(expression);
+        m_function = function;
+    }
+    void set_expressions(const NodeList<Expression *> & expressions)
+    {
+        m_expressions = expressions;
+    }
+    const NodeList<Expression *> & get_expressions() const
+    {
+        return m_expressions;
     }
     line_number get_line_number() const
     {
@@ -204,7 +385,7 @@ public:
     {
         return m_function_name;
     }
-    void set_function_name(const std::string & function_name)
+    void set_function_name(const char * function_name)
     {
         m_function_name = function_name;
     }
@@ -212,7 +393,11 @@ public:
     {
         m_line_number = ln;
     }
-    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    EXPRESSION get_expression_type() const
+    {
+        return EXPRESSION::CALL_EXPRESSION;
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table);
 };
 class DecimalExpression : public Expression
 {
@@ -227,7 +412,11 @@ public:
     {
         m_sdt = decimal;
     }
-    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+    EXPRESSION get_expression_type() const
+    {
+        return EXPRESSION::DECIMAL_EXPRESSION;
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table)
     {
         return m_sdt;
     }
@@ -236,68 +425,81 @@ public:
 class Stmt
 {
 public:
-    virtual void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string) =0;
+    virtual void execute(FunctionTable & function_table,VariableTable * variable_table) =0;
+    virtual STMT get_stmt_type() const =0;
     virtual ~Stmt() {}
 };
 
 class PrintStmt : public Stmt
 {
 private:
-    std::string m_prompt;
-    bool has_prompt;
-    std::vector<Expression *> m_expressions;
+    const char * m_prompt;
+    bool m_has_prompt;
+    NodeList<Expression *> m_expressions;
 public:
-    ~PrintStmt()
+    PrintStmt() : m_prompt(""), m_has_prompt(false) {}
+    bool has_prompt() const
     {
-        for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
-        {
-            delete (*it);
-        }
+        return m_has_prompt;
     }
     std::string get_prompt() const
     {
         return m_prompt;
     }
-    void set_prompt(const std::string & prompt)
+    void set_prompt(const char * prompt)
     {
         m_prompt = prompt;
-        has_prompt = true;
+        m_has_prompt = true;
     }
-    void add_expression(Expression * expression)
+    void set_expressions(const NodeList<Expression *> & expressions)
     {
-        m_expressions.push_back(expression);
+        m_expressions = expressions;
     }
-    void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    const NodeList<Expression *> & get_expressions() const
+    {
+        return m_expressions;
+    }
+    STMT get_stmt_type() const
+    {
+        return STMT::PRINT_STMT;
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
 };
 
 class InputStmt : public Stmt
 {
 private:
-    std::string m_prompt;
-    bool has_prompt;
-    std::vector<VariableExpression *> m_expressions;
+    const char * m_prompt;
+    bool m_has_prompt;
+    NodeList<VariableExpression *> m_expressions;
 public:
-    ~InputStmt()
+    InputStmt() : m_prompt(""), m_has_prompt(false) {}
+    bool has_prompt() const
     {
-        for(auto it =  m_expressions.begin() ; it != m_expressions.end() ; ++it)
-        {
-            delete (*it);
-        }
+        return m_has_prompt;
     }
     std::string get_prompt() const
     {
         return m_prompt;
     }
-    void set_prompt(const std::string & prompt)
+    void set_prompt(const char * prompt)
     {
         m_prompt = prompt;
-        has_prompt = true;
+        m_has_prompt = true;
+    }
+    void set_expressions(const NodeList<VariableExpression *> & expressions)
+    {
+        m_expressions = expressions;
+    }
+    const NodeList<VariableExpression *> & get_expressions() const
+    {
+        return m_expressions;
     }
-    void add_expression(VariableExpression * expression)
+    STMT get_stmt_type() const
     {
-        m_expressions.push_back(expression);
+        return STMT::INPUT_STMT;
     }
-    void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
 };
 
 class AssignmentStmt : public Stmt
@@ -306,11 +508,6 @@ private:
     VariableExpression * m_variable_expression;
     Expression * m_expression;
 public:
-    ~AssignmentStmt()
-    {
-        delete m_expression;
-        delete m_variable_expression;
-    }
     VariableExpression * get_variable_expression() const
     {
         return m_variable_expression;
@@ -327,23 +524,19 @@ public:
     {
         m_expression = expression;
     }
-    void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    STMT get_stmt_type() const
+    {
+        return STMT::ASSIGNMENT_STMT;
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
 };
 
 class DOIteratorStmt : public Stmt
 {
 private:
     Expression * m_condition;
-    std::vector<Stmt *> m_stmts;
+    NodeList<Stmt *> m_stmts;
 public:
-    ~DOIteratorStmt()
-    {
-        delete m_condition;
-        for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
-        {
-            delete (*it);
-        }
-    }
     Expression * get_condition() const
     {
         return m_condition;
@@ -352,31 +545,27 @@ public:
     {
         m_condition = expression;
     }
-    void add_stmt(Stmt * stmt)
+    void set_stmts(const NodeList<Stmt *> & stmts)
     {
-        m_stmts.push_back(stmt);
+        m_stmts = stmts;
     }
-    void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    const NodeList<Stmt *> & get_stmts() const
+    {
+        return m_stmts;
+    }
+    STMT get_stmt_type() const
+    {
+        return STMT::DO_ITERATOR_STMT;
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
 };
 class SelectionStmt : public Stmt
 {
 private:
     Expression * m_condition;
-    std::vector<Stmt *> m_true_stmts;
-    std::vector<Stmt *> m_false_stmts;
+    NodeList<Stmt *> m_true_stmts;
+    NodeList<Stmt *> m_false_stmts;
 public:
-    ~SelectionStmt()
-    {
-        delete m_condition;
-        for(auto it =  m_true_stmts.begin() ; it != m_true_stmts.end() ; ++it)
-        {
-            delete (*it);
-        }
-        for(auto it =  m_false_stmts.begin() ; it != m_false_stmts.end() ; ++it)
-        {
-            delete (*it);
-        }
-    }
     Expression * get_condition() const
     {
         return m_condition;
@@ -385,30 +574,34 @@ public:
     {
         m_condition = expression;
     }
-    void add_true_stmt(Stmt * stmt)
+    void set_true_stmts(const NodeList<Stmt *> & true_stmts)
     {
-        m_true_stmts.push_back(stmt);
+        m_true_stmts = true_stmts;
     }
-    void add_false_stmt(Stmt * stmt)
+    void set_false_stmts(const NodeList<Stmt *> & false_stmts)
     {
-        m_false_stmts.push_back(stmt);
+        m_false_stmts = false_stmts;
     }
-    void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    const NodeList<Stmt *> & get_true_stmts() const
+    {
+        return m_true_stmts;
+    }
+    const NodeList<Stmt *> & get_false_stmts() const
+    {
+        return m_false_stmts;
+    }
+    STMT get_stmt_type() const
+    {
+        return STMT::SELECTION_STMT;
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
 };
 class WHILEIteratorStmt : public Stmt
 {
 private:
     Expression * m_condition;
-    std::vector<Stmt *> m_stmts;
+    NodeList<Stmt *> m_stmts;
 public:
-    ~WHILEIteratorStmt()
-    {
-        delete m_condition;
-        for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
-        {
-            delete (*it);
-        }
-    }
     Expression * get_condition() const
     {
         return m_condition;
@@ -417,29 +610,74 @@ public:
     {
         m_condition = expression;
     }
-    void add_stmt(Stmt * stmt)
+    void set_stmts(const NodeList<Stmt *> & stmts)
+    {
+        m_stmts = stmts;
+    }
+    const NodeList<Stmt *> & get_stmts() const
+    {
+        return m_stmts;
+    }
+    STMT get_stmt_type() const
+    {
+        return STMT::WHILE_ITERATOR_STMT;
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
+};
+
+//Block, a scope of its own, left by the optimizer where a branch or loop is always taken once
+class BlockStmt : public Stmt
+{
+private:
+    NodeList<Stmt *> m_stmts;
+public:
+    void set_stmts(const NodeList<Stmt *> & stmts)
+    {
+        m_stmts = stmts;
+    }
+    const NodeList<Stmt *> & get_stmts() const
     {
-        m_stmts.push_back(stmt);
+        return m_stmts;
     }
-    void execute(FunctionTable & function_table,VariableTable * variable_table) throw(std::string);
+    STMT get_stmt_type() const
+    {
+        return STMT::BLOCK_STMT;
+    }
+    void execute(FunctionTable & function_table,VariableTable * variable_table);
 };
 class Program
 {
 private:
-    std::vector<Stmt *> m_stmts;
+    //Owns every node, freeing the Program releases the whole tree at once
+    Arena m_arena;
+    NodeList<Stmt *> m_stmts;
+    std::vector<std::string> m_variable_names;
 public:
-    ~Program()
+    Arena & get_arena()
     {
-        for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
-        {
-            delete (*it);
-        }
+        return m_arena;
     }
-    void add_stmt(Stmt * stmt)
+    void set_stmts(const NodeList<Stmt *> & stmts)
     {
-        m_stmts.push_back(stmt);
+        m_stmts = stmts;
     }
-    void run(FunctionTable & function_table,VariableTable * variable_table) throw(std::string)
+    const NodeList<Stmt *> & get_stmts() const
+    {
+        return m_stmts;
+    }
+    void add_variable_name(const std::string & variable_name)
+    {
+        m_variable_names.push_back(variable_name);
+    }
+    const std::vector<std::string> & get_variable_names() const
+    {
+        return m_variable_names;
+    }
+    std::size_t get_variable_count() const
+    {
+        return m_variable_names.size();
+    }
+    void run(FunctionTable & function_table,VariableTable * variable_table)
     {
         for(auto it =  m_stmts.begin() ; it != m_stmts.end() ; ++it)
         {
@@ -448,5 +686,6 @@ public:
     }
 };
 }
+}
 
 #endif // LANGUAGE_H_INCLUDED
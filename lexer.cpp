@@ -2,78 +2,124 @@
 #include "language.h"
 #include <cctype>
 #include <string>
-#include <cmath>
 
 namespace SBASIC
 {
-TokenReader::TokenReader(std::istream & is) : m_is(is), m_current_char('\0'),m_line_number(1)
+inline namespace SBASIC_NUMERIC
+{
+TokenReader::TokenReader(const char * begin,const char * end) : m_begin(begin), m_end(end), m_position(begin), m_current_char('\0'),m_line_number(1)
 {
     read_char();
 }
 
-std::string TokenReader::read_digit()
+const char * TokenReader::skip_digit(const char * ptr) const
 {
-    std::string str;
-    str += m_current_char;
-    for(read_char(); std::isdigit(m_current_char); read_char())
+    for(; ptr != m_end && std::isdigit(*ptr); ++ptr)
     {
-        str += m_current_char;
+        continue;
     }
-    return str;
+    return ptr;
 }
 
-std::string TokenReader::read_string() throw(std::string)
+Token TokenReader::read_decimal()
 {
-    std::string n_str;
-    n_str += m_current_char;
-    for(read_char(); m_current_char != '"'; read_char())
+    //Integer [. decimal] [E [+|-] exponent], converted in one pass from the source
+    const char * start = m_position - 1;
+    const char * ptr = skip_digit(m_position);
+    if(ptr != m_end && *ptr == '.')
     {
-        if(m_current_char == '0' || m_current_char == '\n')
+        ++ptr;
+        if(ptr == m_end || !std::isdigit(*ptr))
         {
-            throw create_error("Not found end \"",m_line_number);
+            m_position = ptr;
+            read_char();
+            throw create_error("Lack of decimal",m_line_number);
         }
-        n_str += m_current_char;
+        ptr = skip_digit(ptr);
     }
+    if(ptr != m_end && (*ptr == 'E' || *ptr == 'e'))
+    {
+        ++ptr;
+        if(ptr != m_end && (*ptr == '+' || *ptr == '-'))
+        {
+            ++ptr;
+        }
+        if(ptr == m_end || !std::isdigit(*ptr))
+        {
+            m_position = ptr;
+            read_char();
+            throw create_error("Lack of exponent",m_line_number);
+        }
+        ptr = skip_digit(ptr);
+    }
+    m_position = ptr;
     read_char();
-    return n_str;
+    return Token(m_line_number,string_to_decimal(start,ptr));
 }
 
-std::string TokenReader::read_word()
+std::size_t TokenReader::read_string()
 {
-    std::string str;
-    str += m_current_char;
-    for(read_char(); std::isalpha(m_current_char) || std::isdigit(m_current_char) || m_current_char == '.'; read_char())
+    //Strings never span lines, so scan the bytes directly
+    const char * ptr = m_position;
+    for(; ptr != m_end && *ptr != '"'; ++ptr)
+    {
+        if(*ptr == '\0' || *ptr == '\n' || *ptr == '\r')
+        {
+            break;
+        }
+    }
+    if(ptr == m_end || *ptr != '"')
     {
-        str += m_current_char;
+        m_position = ptr;
+        read_char();
+        throw create_error("Not found end \"",m_line_number);
     }
-    return str;
+    std::size_t length = std::size_t(ptr - m_position) + 1;
+    m_position = ptr + 1;
+    read_char();
+    return length;
 }
 
-void TokenReader::read_char()
+std::size_t TokenReader::read_word()
 {
-    static bool CRLF = false;
-    if(m_is.get(m_current_char))
+    const char * ptr = m_position;
+    for(; ptr != m_end && (std::isalpha(*ptr) || std::isdigit(*ptr) || *ptr == '.'); ++ptr)
     {
-        //Success
-        if(m_current_char == '\n' || CRLF)
-        {
-            CRLF = false;
-            m_line_number++;
-        }
-        else if(m_current_char == '\r')
-        {
-            CRLF = true;
-            read_char();
-        }
+        continue;
     }
-    else
+    std::size_t length = std::size_t(ptr - m_position) + 1;
+    m_position = ptr;
+    read_char();
+    return length;
+}
+
+void TokenReader::read_char()
+{
+    if(m_position == m_end)
     {
         //EOF
         m_current_char = '\0';
+        return;
+    }
+    m_current_char = *m_position++;
+    if(m_current_char == '\n')
+    {
+        m_line_number++;
+    }
+    else if(m_current_char == '\r')
+    {
+        //CR LF, or a lone CR, ends one line
+        if(m_position == m_end)
+        {
+            m_current_char = '\0';
+            return;
+        }
+        m_current_char = *m_position++;
+        m_line_number++;
     }
 }
 
-Token * TokenReader::read_token() throw(std::string)
+Token TokenReader::read_token()
 {
     //Ignore white characters
     for(; m_current_char == ' ' || m_current_char == '\t'; read_char())
@@ -83,91 +129,38 @@ Token * TokenReader::read_token() throw(std::string)
 
     if(std::isdigit(m_current_char))
     {
-        // Decimal
-        std::string integer = read_digit();
-        if (m_current_char == '.')
-        {
-            read_char();
-            if(std::isdigit(m_current_char))
-            {
-                std::string decimal = read_digit();
-                if(m_current_char == 'E' || m_current_char == 'e')
-                {
-                    read_char();
-                    bool negative = false;
-                    if(m_current_char == '+' || m_current_char == '-')
-                    {
-                        negative = (m_current_char == '-');
-                        read_char();
-                    }
-                    if(std::isdigit(m_current_char))
-                    {
-                        std::string exponent = read_digit();
-                        //Integer, decimal and exponent
-                        return new DecimalToken(m_line_number,string_to_decimal(integer + "." + decimal) * std::pow(10,negative ? -std::stoi(exponent) : std::stoi(exponent)));
-                    }
-                    else
-                    {
-                        throw create_error("Lack of exponent",m_line_number);
-                    }
-                }
-                else
-                {
-                    //Integer and decimal
-                    return new DecimalToken(m_line_number,string_to_decimal(integer + "." + decimal));
-                }
-            }
-            else
-            {
-                throw create_error("Lack of decimal",m_line_number);
-            }
-        }
-        else if(m_current_char == 'E' || m_current_char == 'e')
-        {
-            read_char();
-            bool negative = false;
-            if(m_current_char == '+' || m_current_char == '-')
-            {
-                negative = (m_current_char == '-');
-                read_char();
-            }
-            if(std::isdigit(m_current_char))
-            {
-                std::string exponent = read_digit();
-                //Integer and exponent
-                return new DecimalToken(m_line_number,string_to_decimal(integer) * std::pow(10,negative ? -std::stoi(exponent) : std::stoi(exponent)));
-            }
-            else
-            {
-                throw create_error("Lack of exponent",m_line_number);
-            }
-        }
-        else
-        {
-            //Only integer
-            return new DecimalToken(m_line_number,string_to_decimal(integer));
-        }
+        //Decimal
+        return read_decimal();
     }
     else if(m_current_char == '"')
     {
         //String
-        return new StringToken(m_line_number,read_string());
+        const char * start = m_position - 1;
+        std::size_t length = read_string();
+        return Token(TOKEN::STRING_TOKEN,m_line_number,std::size_t(start - m_begin),(unsigned int)length);
     }
     else if(std::isalpha(m_current_char))
     {
         //Word
-        std::string word = read_word();
-        if(is_keyword(word))
+        const char * start = m_position - 1;
+        std::size_t length = read_word();
+        const ReservedWord * reserved_word = find_reserved_word(start,length);
+        if(reserved_word == nullptr)
+        {
+            //Identifier
+            return Token(TOKEN::IDENTIFIER_TOKEN,m_line_number,std::size_t(start - m_begin),(unsigned int)length);
+        }
+        else if(reserved_word->word_type == WORD::KEYWORD_WORD)
         {
             //Keyword
-            return new KeywordToken(m_line_number,string_to_keyword(word));
+            return Token(m_line_number,reserved_word->keyword);
         }
-        else if(is_letter_operator(word))
+        else if(reserved_word->word_type == WORD::LETTER_OPERATOR_WORD)
         {
             //Letter operator
-            return new OperatorToken(m_line_number,string_to_letter_operator(word));
+            return Token(m_line_number,reserved_word->letter_operator);
         }
-        else if(word == "REM")
+        else
         {
             //Comment
             for(; m_current_char != '\n' && m_current_char != '\0'; read_char())
@@ -180,11 +173,6 @@ Token * TokenReader::read_token() throw(std::string)
             }
             return read_token();
         }
-        else
-        {
-            //Identifier
-            return new IdentifierToken(m_line_number,word);
-        }
     }
     else if(is_prefix_operator(m_current_char))
     {
@@ -192,42 +180,42 @@ Token * TokenReader::read_token() throw(std::string)
         if(m_current_char == '+')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::PLUS);
+            return Token(m_line_number,OPERATOR::PLUS);
         }
         else if(m_current_char == '-')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::SUBSTRACT);
+            return Token(m_line_number,OPERATOR::SUBSTRACT);
         }
         else if(m_current_char == '*')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::MULTIPLY);
+            return Token(m_line_number,OPERATOR::MULTIPLY);
         }
         else if(m_current_char == '/')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::DIVIDE);
+            return Token(m_line_number,OPERATOR::DIVIDE);
         }
         else if(m_current_char == '\\')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::DIVIDE_EXACTLY);
+            return Token(m_line_number,OPERATOR::DIVIDE_EXACTLY);
         }
         else if(m_current_char == '^')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::POWER);
+            return Token(m_line_number,OPERATOR::POWER);
         }
         else if(m_current_char == '%')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::MOD);
+            return Token(m_line_number,OPERATOR::MOD);
         }
         else if(m_current_char == '=')
         {
             read_char();
-            return new OperatorToken(m_line_number,OPERATOR::EQUAL);
+            return Token(m_line_number,OPERATOR::EQUAL);
         }
         else if(m_current_char == '>')
         {
@@ -235,11 +223,11 @@ Token * TokenReader::read_token() throw(std::string)
             if(m_current_char == '=')
             {
                 read_char();
-                return new OperatorToken(m_line_number,OPERATOR::GREATER_THEN_OR_EQUAL);
+                return Token(m_line_number,OPERATOR::GREATER_THEN_OR_EQUAL);
             }
             else
             {
-                return new OperatorToken(m_line_number,OPERATOR::GREATER_THEN);
+                return Token(m_line_number,OPERATOR::GREATER_THEN);
             }
         }
         else
@@ -248,16 +236,16 @@ Token * TokenReader::read_token() throw(std::string)
             if(m_current_char == '=')
             {
                 read_char();
-                return new OperatorToken(m_line_number,OPERATOR::LESS_THEN_OR_EQUAL);
+                return Token(m_line_number,OPERATOR::LESS_THEN_OR_EQUAL);
             }
             else if(m_current_char == '>')
             {
                 read_char();
-                return new OperatorToken(m_line_number,OPERATOR::NOT_EQUAL);
+                return Token(m_line_number,OPERATOR::NOT_EQUAL);
             }
             else
             {
-                return new OperatorToken(m_line_number,OPERATOR::LESS_THEN);
+                return Token(m_line_number,OPERATOR::LESS_THEN);
             }
         }
     }
@@ -267,33 +255,33 @@ Token * TokenReader::read_token() throw(std::string)
         if(m_current_char == '\n')
         {
             read_char();
-            return new DelimiterToken(m_line_number,DELIMITER::NEW_LINE);
+            return Token(m_line_number,DELIMITER::NEW_LINE);
         }
         else if(m_current_char == ';')
         {
             read_char();
-            return new DelimiterToken(m_line_number,DELIMITER::SEMICOLON);
+            return Token(m_line_number,DELIMITER::SEMICOLON);
         }
         else if(m_current_char == ',')
         {
             read_char();
-            return new DelimiterToken(m_line_number,DELIMITER::COMMA);
+            return Token(m_line_number,DELIMITER::COMMA);
         }
         else if(m_current_char == '(')
         {
             read_char();
-            return new DelimiterToken(m_line_number,DELIMITER::LEFT_PARENTHESIS);
+            return Token(m_line_number,DELIMITER::LEFT_PARENTHESIS);
         }
         else
         {
             read_char();
-            return new DelimiterToken(m_line_number,DELIMITER::RIGHT_PARENTHESIS);
+            return Token(m_line_number,DELIMITER::RIGHT_PARENTHESIS);
         }
     }
     else if(m_current_char == '\0')
     {
         //EOF
-        return new EOFToken(m_line_number);
+        return Token(TOKEN::EOF_TOKEN,m_line_number);
     }
     else
     {
@@ -304,3 +292,4 @@ Token * TokenReader::read_token() throw(std::string)
     }
 }
 }
+}
@@ -1,131 +1,79 @@
 #ifndef LEXER_H_INCLUDED
 #define LEXER_H_INCLUDED
 
-#include <iostream>
 #include <string>
 #include "language.h"
 namespace SBASIC
 {
-//Token
+inline namespace SBASIC_NUMERIC
+{
+//Token, a plain value: the tag selects which payload is valid
 class Token
 {
 private:
+    TOKEN m_token_type;
     line_number m_line_number;
+    unsigned int m_text_length;
+    union
+    {
+        sbasic_decimal_type m_decimal;
+        KEYWORD m_keyword;
+        OPERATOR m_operator;
+        DELIMITER m_delimiter;
+        std::size_t m_text_offset;
+    };
 public:
-    Token(line_number ln) : m_line_number(ln) {};
-    virtual ~Token() {}
+    Token() : m_token_type(TOKEN::EOF_TOKEN), m_line_number(0), m_text_length(0), m_text_offset(0) {}
+    Token(TOKEN token_type,line_number ln) : m_token_type(token_type), m_line_number(ln), m_text_length(0), m_text_offset(0) {}
+    Token(TOKEN token_type,line_number ln,std::size_t text_offset,unsigned int text_length) : m_token_type(token_type), m_line_number(ln), m_text_length(text_length), m_text_offset(text_offset) {}
+    Token(line_number ln,sbasic_decimal_type decimal) : m_token_type(TOKEN::DECIMAL_TOKEN), m_line_number(ln), m_text_length(0), m_decimal(decimal) {}
+    Token(line_number ln,KEYWORD keyword) : m_token_type(TOKEN::KEYWORD_TOKEN), m_line_number(ln), m_text_length(0), m_keyword(keyword) {}
+    Token(line_number ln,OPERATOR op) : m_token_type(TOKEN::OPERATOR_TOKEN), m_line_number(ln), m_text_length(0), m_operator(op) {}
+    Token(line_number ln,DELIMITER delimiter) : m_token_type(TOKEN::DELIMITER_TOKEN), m_line_number(ln), m_text_length(0), m_delimiter(delimiter) {}
+    TOKEN get_token_type() const
+    {
+        return m_token_type;
+    }
     line_number get_line_number() const
     {
         return m_line_number;
     }
-    virtual TOKEN get_token_type() const =0;
-};
-class DecimalToken : public Token
-{
-private:
-    sbasic_decimal_type m_decimal;
-public:
-    DecimalToken(line_number ln,sbasic_decimal_type decimal) : Token(ln),m_decimal(decimal) {}
     sbasic_decimal_type get_decimal() const
     {
         return m_decimal;
     }
-    TOKEN get_token_type() const
-    {
-        return TOKEN::DECIMAL_TOKEN;
-    }
-};
-class IdentifierToken : public Token
-{
-private:
-    std::string m_identifier;
-public:
-    IdentifierToken(line_number ln,const std::string & id) : Token(ln),m_identifier(id) {}
-    std::string get_identifier() const
-    {
-        return m_identifier;
-    }
-    TOKEN get_token_type() const
-    {
-        return TOKEN::IDENTIFIER_TOKEN;
-    }
-};
-class NewlineToken : public Token
-{
-public:
-    NewlineToken(line_number ln) : Token(ln) {}
-    TOKEN get_token_type() const
-    {
-        return TOKEN::NEWLINE_TOKEN;
-    }
-};
-class StringToken : public Token
-{
-private:
-    std::string m_string;
-public:
-    StringToken(line_number ln, const std::string & str) : Token(ln), m_string(str) {}
-    std::string get_string() const
-    {
-        return m_string;
-    }
-    TOKEN get_token_type() const
-    {
-        return TOKEN::STRING_TOKEN;
-    }
-};
-class KeywordToken : public Token
-{
-private:
-    KEYWORD m_keyword;
-public:
-    KeywordToken(line_number ln, KEYWORD keyword) : Token(ln),m_keyword(keyword) {}
     KEYWORD get_keyword() const
     {
         return m_keyword;
     }
-    TOKEN get_token_type() const
+    OPERATOR get_operator() const
     {
-        return TOKEN::KEYWORD_TOKEN;
+        return m_operator;
     }
-};
-class EOFToken : public Token
-{
-public:
-    EOFToken(line_number ln) : Token(ln) {}
-    TOKEN get_token_type() const
+    DELIMITER get_delimiter() const
     {
-        return TOKEN::EOF_TOKEN;
+        return m_delimiter;
     }
-};
-class OperatorToken : public Token
-{
-private:
-    OPERATOR m_operator;
-public:
-    OperatorToken(line_number ln, OPERATOR op) : Token(ln),m_operator(op) {}
-    OPERATOR get_operator() const
+    //Identifier and string text, see TokenReader::get_text
+    std::size_t get_text_offset() const
     {
-        return m_operator;
+        return m_text_offset;
     }
-    TOKEN get_token_type() const
+    unsigned int get_text_length() const
     {
-        return TOKEN::OPERATOR_TOKEN;
+        return m_text_length;
     }
-};
-class DelimiterToken : public Token
-{
-private:
-    DELIMITER m_delimiter;
-public:
-    DelimiterToken(line_number ln, DELIMITER delimiter) : Token(ln),m_delimiter(delimiter) {}
-    DELIMITER get_delimiter() const
+    bool is_keyword(KEYWORD keyword) const
     {
-        return m_delimiter;
+        return m_token_type == TOKEN::KEYWORD_TOKEN && m_keyword == keyword;
     }
-    TOKEN get_token_type() const
+    bool is_operator(OPERATOR op) const
+    {
+        return m_token_type == TOKEN::OPERATOR_TOKEN && m_operator == op;
+    }
+    bool is_delimiter(DELIMITER delimiter) const
     {
-        return TOKEN::DELIMITER_TOKEN;
+        return m_token_type == TOKEN::DELIMITER_TOKEN && m_delimiter == delimiter;
     }
 };
 
@@ -133,25 +81,31 @@ public:
 class TokenReader
 {
 private:
-    std::istream & m_is;
+    //Source span, m_position is the character after m_current_char
+    const char * m_begin;
+    const char * m_end;
+    const char * m_position;
     char m_current_char;
     line_number m_line_number;
     void read_char();
-    std::string read_digit();
-    std::string read_string() throw(std::string);
-    std::string read_word();
+    const char * skip_digit(const char * ptr) const;
+    Token read_decimal();
+    std::size_t read_string();
+    std::size_t read_word();
     std::string create_error(const std::string & error,line_number ln)
     {
         return "Line: " + std::to_string(ln) + ", Error: " + error;
     }
 public:
-    TokenReader(std::istream & is);
-    Token * read_token() throw(std::string);
-    void delete_token(Token * token_ptr)
+    TokenReader(const char * begin,const char * end);
+    Token read_token();
+    //Identifier and string tokens are views into the source
+    const char * get_text(const Token & token) const
     {
-        delete token_ptr;
+        return m_begin + token.get_text_offset();
     }
 };
 }
+}
 
 #endif // LEXER_H_INCLUDED
@@ -0,0 +1,40 @@
+#include "loader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SBASIC_PLUGIN_DLOPEN
+#include <dlfcn.h>
+#endif // defined
+
+namespace SBASIC
+{
+PluginLibrary::PluginLibrary(const std::string & file_name) : m_handle(nullptr), m_plugin(nullptr)
+{
+#if defined SBASIC_PLUGIN_DLOPEN
+    //Every symbol is resolved now, a missing one fails here rather than in the middle of a run
+    m_handle = dlopen(file_name.c_str(),RTLD_NOW | RTLD_LOCAL);
+    if(m_handle == nullptr)
+    {
+        throw "Can not load the plugin \"" + file_name + "\": " + dlerror();
+    }
+    void * entry = dlsym(m_handle,SBASIC_PLUGIN_ENTRY);
+    if(entry != nullptr)
+    {
+        m_plugin = reinterpret_cast<sbasic_plugin_entry_pointer>(entry)();
+    }
+    if(m_plugin == nullptr || m_plugin->version != SBASIC_PLUGIN_VERSION)
+    {
+        dlclose(m_handle);
+        throw "The plugin \"" + file_name + "\" is not built for this SBASIC";
+    }
+#else
+    throw "Can not load the plugin \"" + file_name + "\": plugins are not supported on this platform";
+#endif // SBASIC_PLUGIN_DLOPEN
+}
+
+PluginLibrary::~PluginLibrary()
+{
+#if defined SBASIC_PLUGIN_DLOPEN
+    dlclose(m_handle);
+#endif // SBASIC_PLUGIN_DLOPEN
+}
+}
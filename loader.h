@@ -0,0 +1,28 @@
+#ifndef LOADER_H_INCLUDED
+#define LOADER_H_INCLUDED
+
+#include <string>
+#include "plugin.h"
+namespace SBASIC
+{
+//PluginLibrary, a plugin loaded once, its entry point called and its version checked at load
+//Functions bound to it must not be called after it is destroyed
+class PluginLibrary
+{
+private:
+    void * m_handle;
+    const sbasic_plugin * m_plugin;
+public:
+    //A file name without a slash is searched for like any shared library
+    PluginLibrary(const std::string & file_name);
+    PluginLibrary(const PluginLibrary &) = delete;
+    PluginLibrary & operator=(const PluginLibrary &) = delete;
+    ~PluginLibrary();
+    const sbasic_plugin & get_plugin() const
+    {
+        return *m_plugin;
+    }
+};
+}
+
+#endif // LOADER_H_INCLUDED
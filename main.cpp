@@ -1,32 +1,107 @@
 #include <iostream>
-#include <fstream>
-#include "language.h"
-#include "analyzer.h"
-#include "lexer.h"
+#include <string>
+#include "run.h"
+#include "output.h"
 
 using namespace std;
 using namespace SBASIC;
 
 int main(int argc,char *argv[])
 {
-    if(argc == 2)
+    //Options
+    Options options;
+    string numeric = "double";
+    string flush = "auto";
+    for(int i = 1; i < argc; ++i)
     {
-        try
+        string arg = argv[i];
+        if(arg.compare(0,9,"--engine=") == 0)
         {
-            char * file_name = argv[1];
-            ifstream ifs(file_name);
-            TokenReader token_reader(ifs);
-            SyntaxAnalyer syntax_analyer(token_reader);
-            Program * program = syntax_analyer.analyer();
-            FunctionTable function_table;
-            VariableTable variable_table(nullptr);
-            program->run(function_table,&variable_table);
-            syntax_analyer.delete_program(program);
+            options.engine = arg.substr(9);
         }
-        catch(string & err)
+        else if(arg.compare(0,10,"--numeric=") == 0)
         {
-            std::cout << err << endl;
+            numeric = arg.substr(10);
         }
+        else if(arg.compare(0,8,"--flush=") == 0)
+        {
+            flush = arg.substr(8);
+        }
+        else if(arg == "--legacy-format")
+        {
+            standard_output.set_number_format(NUMBER_FORMAT::LEGACY);
+        }
+        else if(arg == "--no-optimize")
+        {
+            options.optimize = false;
+        }
+        else if(arg == "--emit-cpp" || arg.compare(0,11,"--emit-cpp=") == 0)
+        {
+            //Without a file name the C++ goes to standard output
+            options.emit_cpp = true;
+            options.cpp_file_name = arg.size() > 11 ? arg.substr(11) : "";
+        }
+        else if(arg == "--cache" || arg.compare(0,8,"--cache=") == 0)
+        {
+            //Without a directory the cache file goes next to the source
+            options.cache = true;
+            options.cache_directory = arg.size() > 8 ? arg.substr(8) : "";
+        }
+        else if(arg.compare(0,9,"--plugin=") == 0)
+        {
+            options.plugins.push_back(arg.substr(9));
+        }
+        else if(arg == "--jit")
+        {
+            options.jit = true;
+        }
+        else if(options.file_name == nullptr)
+        {
+            options.file_name = argv[i];
+        }
+        else
+        {
+            options.file_name = nullptr;
+            break;
+        }
+    }
+    if(options.engine != "tree" && options.engine != "vm" && options.engine != "closure")
+    {
+        std::cout << "Unknown engine: " << options.engine << endl;
+        return 0;
+    }
+    if(numeric != "float" && numeric != "double" && numeric != "long-double")
+    {
+        std::cout << "Unknown numeric type: " << numeric << endl;
+        return 0;
+    }
+    //A number is a count of bytes
+    if(flush == "auto" || flush == "line" || flush == "full" || flush == "exit")
+    {
+        standard_output.set_policy(flush == "auto" ? FLUSH_POLICY::AUTO : flush == "line" ? FLUSH_POLICY::LINE : flush == "full" ? FLUSH_POLICY::FULL : FLUSH_POLICY::EXIT,0);
+    }
+    else if(!flush.empty() && flush.find_first_not_of("0123456789") == string::npos && flush.size() < 10 && stoul(flush) > 0)
+    {
+        standard_output.set_policy(FLUSH_POLICY::BYTES,stoul(flush));
+    }
+    else
+    {
+        std::cout << "Unknown flush policy: " << flush << endl;
+        return 0;
+    }
+
+    if(options.file_name != nullptr)
+    {
+        //The decimal type is picked once, each build of the core runs at full speed
+        if(numeric == "float")
+        {
+            return numeric_float::run(options);
+        }
+        else if(numeric == "long-double")
+        {
+            return numeric_long_double::run(options);
+        }
+        return numeric_double::run(options);
     }
     else
     {
@@ -0,0 +1,242 @@
+#include "optimizer.h"
+#include "specialized.h"
+#include <cmath>
+#include <vector>
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+void Optimizer::optimize(Program * program)
+{
+    m_program = program;
+    program->set_stmts(stmts(program->get_stmts()));
+    m_program = nullptr;
+}
+
+NodeList<Stmt *> Optimizer::stmts(const NodeList<Stmt *> & stmts)
+{
+    //Statements only ever disappear, so the list is compacted in place
+    std::size_t count = 0;
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        Stmt * stmt_ptr = stmt(*it);
+        if(stmt_ptr != nullptr)
+        {
+            stmts[count++] = stmt_ptr;
+        }
+    }
+    return NodeList<Stmt *>(stmts.begin(),count);
+}
+
+Stmt * Optimizer::stmt(Stmt * stmt_ptr)
+{
+    switch(stmt_ptr->get_stmt_type())
+    {
+    case STMT::PRINT_STMT:
+    {
+        const NodeList<Expression *> & exps = static_cast<PrintStmt *>(stmt_ptr)->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            *it = expression(*it);
+        }
+        return stmt_ptr;
+    }
+    case STMT::INPUT_STMT:
+        return stmt_ptr;
+    case STMT::ASSIGNMENT_STMT:
+    {
+        AssignmentStmt * assignment_stmt_ptr = static_cast<AssignmentStmt *>(stmt_ptr);
+        assignment_stmt_ptr->set_expression(expression(assignment_stmt_ptr->get_expression()));
+        return stmt_ptr;
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        DOIteratorStmt * do_stmt_ptr = static_cast<DOIteratorStmt *>(stmt_ptr);
+        do_stmt_ptr->set_stmts(stmts(do_stmt_ptr->get_stmts()));
+        do_stmt_ptr->set_condition(expression(do_stmt_ptr->get_condition()));
+        if(is_constant(do_stmt_ptr->get_condition()) && constant(do_stmt_ptr->get_condition()) == sbasic_true)
+        {
+            //LOOP UNTIL true, the body runs once
+            return block(do_stmt_ptr->get_stmts());
+        }
+        return stmt_ptr;
+    }
+    case STMT::SELECTION_STMT:
+    {
+        SelectionStmt * selection_stmt_ptr = static_cast<SelectionStmt *>(stmt_ptr);
+        selection_stmt_ptr->set_condition(expression(selection_stmt_ptr->get_condition()));
+        selection_stmt_ptr->set_true_stmts(stmts(selection_stmt_ptr->get_true_stmts()));
+        selection_stmt_ptr->set_false_stmts(stmts(selection_stmt_ptr->get_false_stmts()));
+        if(is_constant(selection_stmt_ptr->get_condition()))
+        {
+            //Only the taken branch is kept, still in a scope of its own
+            return block(constant(selection_stmt_ptr->get_condition()) == sbasic_true ? selection_stmt_ptr->get_true_stmts() : selection_stmt_ptr->get_false_stmts());
+        }
+        return stmt_ptr;
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        WHILEIteratorStmt * while_stmt_ptr = static_cast<WHILEIteratorStmt *>(stmt_ptr);
+        while_stmt_ptr->set_condition(expression(while_stmt_ptr->get_condition()));
+        if(is_constant(while_stmt_ptr->get_condition()) && constant(while_stmt_ptr->get_condition()) != sbasic_true)
+        {
+            //Never entered
+            return nullptr;
+        }
+        while_stmt_ptr->set_stmts(stmts(while_stmt_ptr->get_stmts()));
+        return stmt_ptr;
+    }
+    case STMT::BLOCK_STMT:
+    {
+        BlockStmt * block_stmt_ptr = static_cast<BlockStmt *>(stmt_ptr);
+        return block(stmts(block_stmt_ptr->get_stmts()));
+    }
+    }
+    return stmt_ptr;
+}
+
+Stmt * Optimizer::block(const NodeList<Stmt *> & stmts)
+{
+    if(stmts.empty())
+    {
+        return nullptr;
+    }
+    BlockStmt * block_stmt_ptr = m_program->get_arena().create<BlockStmt>();
+    block_stmt_ptr->set_stmts(stmts);
+    return block_stmt_ptr;
+}
+
+Expression * Optimizer::expression(Expression * expression_ptr)
+{
+    switch(expression_ptr->get_expression_type())
+    {
+    case EXPRESSION::UNARY_EXPRESSION:
+        return unary(static_cast<UnaryExpression *>(expression_ptr));
+    case EXPRESSION::BINARY_EXPRESSION:
+    {
+        //Left operands on the way down the chain, then folded from its bottom up
+        std::vector<std::pair<BinaryExpression *,Expression *>> chain;
+        while(expression_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+        {
+            BinaryExpression * binary_exp_ptr = static_cast<BinaryExpression *>(expression_ptr);
+            chain.push_back(std::make_pair(binary_exp_ptr,expression(binary_exp_ptr->get_left_expression())));
+            expression_ptr = binary_exp_ptr->get_right_expression();
+        }
+        expression_ptr = expression(expression_ptr);
+        for(auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            expression_ptr = binary(it->first,it->second,expression_ptr);
+        }
+        return expression_ptr;
+    }
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        const NodeList<Expression *> & exps = static_cast<CallExpression *>(expression_ptr)->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            *it = expression(*it);
+        }
+        return expression_ptr;
+    }
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    case EXPRESSION::DECIMAL_EXPRESSION:
+        break;
+    }
+    return expression_ptr;
+}
+
+Expression * Optimizer::unary(UnaryExpression * unary_expression)
+{
+    //Nodes are rebuilt rather than patched, specialized nodes cache their operands
+    OPERATOR op = unary_expression->get_operator();
+    Expression * operand_ptr = expression(unary_expression->get_expression());
+    if(operand_ptr != unary_expression->get_expression())
+    {
+        unary_expression = static_cast<UnaryExpression *>(create_unary_expression(m_program->get_arena(),op,operand_ptr));
+    }
+    if(operand_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION)
+    {
+        //Constant operand, compute it once with the same code the tree walker runs
+        return create_decimal(unary_expression->compute(m_function_table,nullptr));
+    }
+    if(op == OPERATOR::PLUS)
+    {
+        //+X is X
+        return operand_ptr;
+    }
+    if(op == OPERATOR::SUBSTRACT && operand_ptr->get_expression_type() == EXPRESSION::UNARY_EXPRESSION && static_cast<UnaryExpression *>(operand_ptr)->get_operator() == OPERATOR::SUBSTRACT)
+    {
+        //-(-X) is X
+        return static_cast<UnaryExpression *>(operand_ptr)->get_expression();
+    }
+    return unary_expression;
+}
+
+//left_ptr and right_ptr are the operands already optimized
+Expression * Optimizer::binary(BinaryExpression * binary_expression,Expression * left_ptr,Expression * right_ptr)
+{
+    OPERATOR op = binary_expression->get_operator();
+    bool left_constant = left_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION;
+    bool right_constant = right_ptr->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION;
+    if(left_ptr != binary_expression->get_left_expression() || right_ptr != binary_expression->get_right_expression())
+    {
+        //Nodes are rebuilt rather than patched, specialized nodes cache their operands
+        binary_expression = static_cast<BinaryExpression *>(create_binary_expression(m_program->get_arena(),op,left_ptr,right_ptr));
+    }
+    if(left_constant && right_constant)
+    {
+        //Every operator is defined on every constant, \ and MOD included
+        return create_decimal(binary_expression->compute(m_function_table,nullptr));
+    }
+    if(left_constant && (op == OPERATOR::AND || op == OPERATOR::OR))
+    {
+        //The right side is skipped at run time when the left side decides
+        sbasic_decimal_type left = static_cast<DecimalExpression *>(left_ptr)->get_decimal();
+        if(op == OPERATOR::AND && left != sbasic_true)
+        {
+            return create_decimal(sbasic_false);
+        }
+        if(op == OPERATOR::OR && left == sbasic_true)
+        {
+            return create_decimal(sbasic_true);
+        }
+        return binary_expression;
+    }
+    //Identities that hold for every value including -0, infinities and NaN, and never drop an operand
+    if(right_constant)
+    {
+        sbasic_decimal_type right = static_cast<DecimalExpression *>(right_ptr)->get_decimal();
+        if(right == 1 && (op == OPERATOR::MULTIPLY || op == OPERATOR::DIVIDE || op == OPERATOR::POWER))
+        {
+            return left_ptr;
+        }
+        if(right == 0 && !std::signbit(right) && op == OPERATOR::SUBSTRACT)
+        {
+            return left_ptr;
+        }
+        if(right == 2 && op == OPERATOR::POWER && left_ptr->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION)
+        {
+            //X^2 is X*X, both are correctly rounded
+            return create_binary_expression(m_program->get_arena(),OPERATOR::MULTIPLY,left_ptr,left_ptr);
+        }
+    }
+    if(left_constant)
+    {
+        sbasic_decimal_type left = static_cast<DecimalExpression *>(left_ptr)->get_decimal();
+        if(left == 1 && op == OPERATOR::MULTIPLY)
+        {
+            return right_ptr;
+        }
+    }
+    return binary_expression;
+}
+
+DecimalExpression * Optimizer::create_decimal(sbasic_decimal_type decimal)
+{
+    DecimalExpression * decimal_exp_ptr = m_program->get_arena().create<DecimalExpression>();
+    decimal_exp_ptr->set_decimal(decimal);
+    return decimal_exp_ptr;
+}
+}
+}
@@ -0,0 +1,37 @@
+#ifndef OPTIMIZER_H_INCLUDED
+#define OPTIMIZER_H_INCLUDED
+
+#include "language.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Optimizer, folds constants and drops dead code without changing what the program prints
+class Optimizer
+{
+private:
+    Program * m_program;
+    FunctionTable m_function_table;
+    NodeList<Stmt *> stmts(const NodeList<Stmt *> & stmts);
+    Stmt * stmt(Stmt * stmt);
+    Stmt * block(const NodeList<Stmt *> & stmts);
+    bool is_constant(const Expression * expression) const
+    {
+        return expression->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION;
+    }
+    sbasic_decimal_type constant(const Expression * expression) const
+    {
+        return static_cast<const DecimalExpression *>(expression)->get_decimal();
+    }
+    Expression * expression(Expression * expression);
+    Expression * unary(UnaryExpression * unary_expression);
+    Expression * binary(BinaryExpression * binary_expression,Expression * left_ptr,Expression * right_ptr);
+    DecimalExpression * create_decimal(sbasic_decimal_type decimal);
+public:
+    Optimizer() : m_program(nullptr) {}
+    void optimize(Program * program);
+};
+}
+}
+
+#endif // OPTIMIZER_H_INCLUDED
@@ -0,0 +1,108 @@
+#include "output.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include "runtime.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SBASIC_OUTPUT_WRITE
+#include <cerrno>
+#include <unistd.h>
+#endif // defined
+
+namespace SBASIC
+{
+OutputBuffer standard_output;
+
+void OutputBuffer::set_policy(FLUSH_POLICY policy,std::size_t bytes)
+{
+    if(policy == FLUSH_POLICY::AUTO)
+    {
+#if defined SBASIC_OUTPUT_WRITE
+        policy = isatty(STDOUT_FILENO) ? FLUSH_POLICY::LINE : FLUSH_POLICY::FULL;
+#else
+        policy = FLUSH_POLICY::FULL;
+#endif // SBASIC_OUTPUT_WRITE
+    }
+    m_policy = policy;
+    if(policy == FLUSH_POLICY::BYTES && bytes > m_buffer.size())
+    {
+        //Holds the whole amount, a smaller buffer would flush when full instead
+        m_buffer.resize(bytes);
+    }
+    //EXIT never reaches its limit, the buffer grows first
+    m_limit = policy == FLUSH_POLICY::BYTES && bytes > 0 ? bytes : (policy == FLUSH_POLICY::EXIT ? SIZE_MAX : CAPACITY);
+}
+
+void OutputBuffer::write(const char * data,std::size_t size)
+{
+    while(size > m_buffer.size() - m_size)
+    {
+        std::size_t part = m_buffer.size() - m_size;
+        std::memcpy(m_buffer.data() + m_size,data,part);
+        m_size += part;
+        full();
+        data += part;
+        size -= part;
+    }
+    std::memcpy(m_buffer.data() + m_size,data,size);
+    m_size += size;
+    limit();
+}
+
+template<typename Decimal>
+void OutputBuffer::write_decimal(Decimal number)
+{
+    while(m_buffer.size() - m_size < sbasic_number_size)
+    {
+        full();
+    }
+    char * text = m_buffer.data() + m_size;
+    m_size = std::size_t(sbasic_format_number(text,number,m_number_format == NUMBER_FORMAT::LEGACY) - m_buffer.data());
+    limit();
+}
+
+void OutputBuffer::write_number(float number)
+{
+    write_decimal(number);
+}
+
+void OutputBuffer::write_number(double number)
+{
+    write_decimal(number);
+}
+
+void OutputBuffer::write_number(long double number)
+{
+    write_decimal(number);
+}
+
+void OutputBuffer::flush()
+{
+#if defined SBASIC_OUTPUT_WRITE
+    //Straight to the file descriptor, one system call for the whole buffer
+    std::cout.flush();
+    const char * data = m_buffer.data();
+    std::size_t size = m_size;
+    while(size > 0)
+    {
+        ssize_t count = ::write(STDOUT_FILENO,data,size);
+        if(count < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            //Nowhere to report it, the output is dropped like std::cout would
+            break;
+        }
+        data += count;
+        size -= std::size_t(count);
+    }
+#else
+    std::cout.write(m_buffer.data(),std::streamsize(m_size));
+    std::cout.flush();
+#endif // SBASIC_OUTPUT_WRITE
+    m_size = 0;
+}
+}
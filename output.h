@@ -0,0 +1,119 @@
+#ifndef OUTPUT_H_INCLUDED
+#define OUTPUT_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+namespace SBASIC
+{
+//When buffered output is written, whatever the policy it is written before INPUT reads so the prompt shows first
+enum class FLUSH_POLICY
+{
+    //LINE on a terminal, FULL otherwise
+    AUTO,
+    //After every line
+    LINE,
+    //When the buffer is full
+    FULL,
+    //Every so many bytes
+    BYTES,
+    //At exit, the buffer grows to hold everything until then
+    EXIT
+};
+
+//How PRINT writes numbers
+enum class NUMBER_FORMAT
+{
+    //The fewest digits that read back as the same number
+    SHORTEST,
+    //Six significant digits, as std::ostream writes them
+    LEGACY
+};
+
+//OutputBuffer, what PRINT and INPUT write, kept in memory until the policy writes it
+class OutputBuffer
+{
+private:
+    static const std::size_t CAPACITY = 65536;
+    std::vector<char> m_buffer;
+    std::size_t m_size;
+    FLUSH_POLICY m_policy;
+    std::size_t m_limit;
+    NUMBER_FORMAT m_number_format;
+    template<typename Decimal>
+    void write_decimal(Decimal number);
+    //Called when the buffer has no room left
+    void full()
+    {
+        if(m_policy == FLUSH_POLICY::EXIT)
+        {
+            m_buffer.resize(m_buffer.size() * 2);
+        }
+        else
+        {
+            flush();
+        }
+    }
+    void limit()
+    {
+        if(m_size >= m_limit)
+        {
+            flush();
+        }
+    }
+public:
+    OutputBuffer() : m_buffer(CAPACITY), m_size(0), m_policy(FLUSH_POLICY::FULL), m_limit(CAPACITY), m_number_format(NUMBER_FORMAT::SHORTEST) {}
+    OutputBuffer(const OutputBuffer &) = delete;
+    OutputBuffer & operator=(const OutputBuffer &) = delete;
+    ~OutputBuffer()
+    {
+        flush();
+    }
+    //bytes is for BYTES
+    void set_policy(FLUSH_POLICY policy,std::size_t bytes);
+    void write(const char * data,std::size_t size);
+    void write(const std::string & str)
+    {
+        write(str.data(),str.size());
+    }
+    void set_number_format(NUMBER_FORMAT number_format)
+    {
+        m_number_format = number_format;
+    }
+    NUMBER_FORMAT get_number_format() const
+    {
+        return m_number_format;
+    }
+    //Written in place, the shortest digits of a float are not those of the same double
+    void write_number(float number);
+    void write_number(double number);
+    void write_number(long double number);
+    void end_line()
+    {
+        if(m_size == m_buffer.size())
+        {
+            full();
+        }
+        m_buffer[m_size++] = '\n';
+        if(m_policy == FLUSH_POLICY::LINE)
+        {
+            flush();
+        }
+        else
+        {
+            limit();
+        }
+    }
+    //Before reading standard input, so the prompt is shown first
+    void before_input()
+    {
+        flush();
+    }
+    void flush();
+};
+
+//Standard output of the running program, anything else written to standard output flushes it first
+extern OutputBuffer standard_output;
+}
+
+#endif // OUTPUT_H_INCLUDED
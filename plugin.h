@@ -0,0 +1,97 @@
+#ifndef PLUGIN_H_INCLUDED
+#define PLUGIN_H_INCLUDED
+
+#include <cstddef>
+#include <utility>
+
+//The interface between SBASIC and a plugin, a shared library of native functions loaded with --plugin
+//A plugin includes only this header:
+//
+//  static double hypot2(double x,double y) { return std::sqrt(x * x + y * y); }
+//  static const sbasic_plugin_function FUNCTIONS[] = { SBASIC::plugin_function<&hypot2>("HYPOT") };
+//  SBASIC_PLUGIN(FUNCTIONS)
+
+//Version of the interface, a plugin built against another one is refused
+#define SBASIC_PLUGIN_VERSION 1
+//The entry point every plugin exports
+#define SBASIC_PLUGIN_ENTRY "sbasic_plugin_entry"
+
+#if defined _WIN32
+#define SBASIC_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define SBASIC_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif // defined
+
+extern "C"
+{
+//A plugin function, once for each decimal type; the arguments are an array as long as its arity
+struct sbasic_plugin_function
+{
+    const char * name;
+    std::size_t arity;
+    float (*float_pointer)(const float * args);
+    double (*double_pointer)(const double * args);
+    long double (*long_double_pointer)(const long double * args);
+};
+//What the entry point returns, it lives as long as the plugin is loaded
+struct sbasic_plugin
+{
+    unsigned int version;
+    std::size_t function_count;
+    const sbasic_plugin_function * functions;
+};
+typedef const sbasic_plugin * (*sbasic_plugin_entry_pointer)();
+}
+
+namespace SBASIC
+{
+//Most arguments a function takes, calls pass them in an array on the stack
+const std::size_t MAX_FUNCTION_ARITY = 8;
+
+//FunctionThunk, calls a native function of fixed arity with the arguments in registers
+template<typename Decimal,typename Signature>
+struct FunctionThunk;
+template<typename Decimal,typename Result,typename... Args>
+struct FunctionThunk<Decimal,Result (*)(Args...)>
+{
+    static constexpr std::size_t arity = sizeof...(Args);
+    static_assert(arity <= MAX_FUNCTION_ARITY,"Too many arguments for an SBASIC function");
+    template<Result (*F)(Args...),std::size_t... I>
+    static Decimal call(const Decimal * args,std::index_sequence<I...>)
+    {
+        (void)args;
+        return Decimal(F(static_cast<Args>(args[I])...));
+    }
+    template<Result (*F)(Args...)>
+    static Decimal call(const Decimal * args)
+    {
+        return call<F>(args,std::index_sequence_for<Args...>());
+    }
+};
+template<typename Decimal,typename Result,typename... Args>
+struct FunctionThunk<Decimal,Result (*)(Args...) noexcept> : FunctionThunk<Decimal,Result (*)(Args...)> {};
+
+//The plugin function of a native function, its arity deduced from the C++ signature
+template<auto F>
+constexpr sbasic_plugin_function plugin_function(const char * name)
+{
+    return sbasic_plugin_function
+    {
+        name,
+        FunctionThunk<double,decltype(F)>::arity,
+        &FunctionThunk<float,decltype(F)>::template call<F>,
+        &FunctionThunk<double,decltype(F)>::template call<F>,
+        &FunctionThunk<long double,decltype(F)>::template call<F>
+    };
+}
+}
+
+//Defines the entry point of a plugin from its array of functions
+#define SBASIC_PLUGIN(functions) \
+extern "C" SBASIC_PLUGIN_EXPORT const sbasic_plugin * sbasic_plugin_entry() \
+{ \
+    static const sbasic_plugin plugin = {SBASIC_PLUGIN_VERSION,sizeof(functions) / sizeof(functions[0]),functions}; \
+    return &plugin; \
+}
+
+#endif // PLUGIN_H_INCLUDED
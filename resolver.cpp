@@ -0,0 +1,112 @@
+#include "resolver.h"
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+void VariableResolver::resolve(Program * program)
+{
+    m_program = program;
+    m_slots.clear();
+    for(auto it = program->get_variable_names().begin(); it != program->get_variable_names().end(); ++it)
+    {
+        m_slots[*it] = variable_slot(m_slots.size());
+    }
+    stmts(program->get_stmts());
+    m_program = nullptr;
+}
+
+void VariableResolver::stmts(const NodeList<Stmt *> & stmts)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        Stmt * stmt_ptr = *it;
+        switch(stmt_ptr->get_stmt_type())
+        {
+        case STMT::PRINT_STMT:
+        {
+            const NodeList<Expression *> & exps = static_cast<PrintStmt *>(stmt_ptr)->get_expressions();
+            for(auto exp_it = exps.begin(); exp_it != exps.end(); ++exp_it)
+            {
+                expression(*exp_it);
+            }
+            break;
+        }
+        case STMT::INPUT_STMT:
+        {
+            const NodeList<VariableExpression *> & exps = static_cast<InputStmt *>(stmt_ptr)->get_expressions();
+            for(auto exp_it = exps.begin(); exp_it != exps.end(); ++exp_it)
+            {
+                variable(*exp_it);
+            }
+            break;
+        }
+        case STMT::ASSIGNMENT_STMT:
+            variable(static_cast<AssignmentStmt *>(stmt_ptr)->get_variable_expression());
+            expression(static_cast<AssignmentStmt *>(stmt_ptr)->get_expression());
+            break;
+        case STMT::DO_ITERATOR_STMT:
+            this->stmts(static_cast<DOIteratorStmt *>(stmt_ptr)->get_stmts());
+            expression(static_cast<DOIteratorStmt *>(stmt_ptr)->get_condition());
+            break;
+        case STMT::SELECTION_STMT:
+            expression(static_cast<SelectionStmt *>(stmt_ptr)->get_condition());
+            this->stmts(static_cast<SelectionStmt *>(stmt_ptr)->get_true_stmts());
+            this->stmts(static_cast<SelectionStmt *>(stmt_ptr)->get_false_stmts());
+            break;
+        case STMT::WHILE_ITERATOR_STMT:
+            expression(static_cast<WHILEIteratorStmt *>(stmt_ptr)->get_condition());
+            this->stmts(static_cast<WHILEIteratorStmt *>(stmt_ptr)->get_stmts());
+            break;
+        case STMT::BLOCK_STMT:
+            this->stmts(static_cast<BlockStmt *>(stmt_ptr)->get_stmts());
+            break;
+        }
+    }
+}
+
+void VariableResolver::expression(Expression * expression_ptr)
+{
+    //Right operands in a loop, see MAX_NESTED_OPERATORS, slots are still given in order of appearance
+    while(expression_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        expression(static_cast<BinaryExpression *>(expression_ptr)->get_left_expression());
+        expression_ptr = static_cast<BinaryExpression *>(expression_ptr)->get_right_expression();
+    }
+    switch(expression_ptr->get_expression_type())
+    {
+    case EXPRESSION::UNARY_EXPRESSION:
+        expression(static_cast<UnaryExpression *>(expression_ptr)->get_expression());
+        break;
+    case EXPRESSION::VARIABLE_EXPRESSION:
+        variable(static_cast<VariableExpression *>(expression_ptr));
+        break;
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        const NodeList<Expression *> & exps = static_cast<CallExpression *>(expression_ptr)->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            expression(*it);
+        }
+        break;
+    }
+    case EXPRESSION::BINARY_EXPRESSION:
+    case EXPRESSION::DECIMAL_EXPRESSION:
+        break;
+    }
+}
+
+void VariableResolver::variable(VariableExpression * variable_expression)
+{
+    //A variable keeps one slot in every block, since assignment never shadows an outer variable
+    const std::string & variable_name = variable_expression->get_variable_name();
+    auto it = m_slots.find(variable_name);
+    if(it == m_slots.end())
+    {
+        it = m_slots.insert(std::make_pair(variable_name,variable_slot(m_slots.size()))).first;
+        m_program->add_variable_name(variable_name);
+    }
+    variable_expression->set_slot(it->second);
+}
+}
+}
@@ -0,0 +1,28 @@
+#ifndef RESOLVER_H_INCLUDED
+#define RESOLVER_H_INCLUDED
+
+#include <string>
+#include <map>
+#include <vector>
+#include "language.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//VariableResolver
+class VariableResolver
+{
+private:
+    Program * m_program;
+    std::map<std::string,variable_slot> m_slots;
+    void stmts(const NodeList<Stmt *> & stmts);
+    void expression(Expression * expression);
+    void variable(VariableExpression * variable_expression);
+public:
+    VariableResolver() : m_program(nullptr) {}
+    void resolve(Program * program);
+};
+}
+}
+
+#endif // RESOLVER_H_INCLUDED
@@ -0,0 +1,129 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <list>
+#include <memory>
+#include "language.h"
+#include "analyzer.h"
+#include "lexer.h"
+#include "source.h"
+#include "bytecode.h"
+#include "vm.h"
+#include "optimizer.h"
+#include "closure.h"
+#include "jit.h"
+#include "transpiler.h"
+#include "cache.h"
+#include "loader.h"
+#include "output.h"
+#include "run.h"
+
+using namespace std;
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+int run(const Options & options)
+{
+    try
+    {
+        SourceFile source_file(options.file_name);
+        //Plugins are loaded once and their functions bound like the standard ones, they outlive the table
+        list<PluginLibrary> plugin_libraries;
+        //Calls are bound to it while parsing, it outlives the program
+        FunctionTable function_table;
+        for(const string & plugin : options.plugins)
+        {
+            plugin_libraries.emplace_back(plugin);
+            function_table.register_plugin(plugin_libraries.back().get_plugin(),plugin);
+        }
+        //Standard input has nowhere to keep a cache file
+        bool cache = options.cache && string(options.file_name) != "-";
+        //Hashing the source is a pass over the whole file, made only when the cache is used
+        unique_ptr<ProgramCache> program_cache;
+        Program * program = nullptr;
+        if(cache)
+        {
+            program_cache.reset(new ProgramCache(options.file_name,options.cache_directory,source_file,options.optimize));
+            program = program_cache->load(function_table);
+        }
+        if(program == nullptr)
+        {
+            TokenReader token_reader(source_file.begin(),source_file.end());
+            SyntaxAnalyer syntax_analyer(token_reader,function_table);
+            program = syntax_analyer.analyer();
+            if(options.optimize)
+            {
+                Optimizer optimizer;
+                optimizer.optimize(program);
+            }
+            if(cache)
+            {
+                program_cache->store(program);
+            }
+        }
+        if(options.emit_cpp)
+        {
+            //Written only once complete, a failed run leaves no half file behind
+            Transpiler transpiler(standard_output.get_number_format());
+            ostringstream cpp;
+            transpiler.transpile(program,options.file_name,cpp);
+            if(options.cpp_file_name.empty())
+            {
+                std::cout << cpp.str();
+            }
+            else
+            {
+                ofstream cpp_file(options.cpp_file_name);
+                if(!(cpp_file << cpp.str()))
+                {
+                    throw "Can not write \"" + options.cpp_file_name + "\"";
+                }
+            }
+        }
+        else if(options.engine == "vm")
+        {
+            BytecodeCompiler bytecode_compiler;
+            Bytecode * bytecode = bytecode_compiler.compile(program);
+            VirtualMachine virtual_machine(*bytecode);
+            virtual_machine.run();
+            bytecode_compiler.delete_bytecode(bytecode);
+        }
+        else if(options.engine == "closure")
+        {
+            ClosureCompiler closure_compiler;
+            ClosureProgram * closure_program = closure_compiler.compile(program);
+            closure_program->run();
+            closure_compiler.delete_program(closure_program);
+        }
+        else
+        {
+            //Hot loops of the tree walker are compiled to native code
+            LoopJit loop_jit;
+            if(options.jit)
+            {
+                loop_jit.install(program);
+            }
+            VariableTable variable_table(program->get_variable_count());
+            program->run(function_table,&variable_table);
+        }
+        delete program;
+    }
+    catch(string & err)
+    {
+        //What the program printed comes before the error
+        standard_output.flush();
+        std::cout << err << endl;
+        if(options.emit_cpp)
+        {
+            //Lets a build generating C++ stop here
+            return 1;
+        }
+    }
+    standard_output.flush();
+    return 0;
+}
+}
+}
@@ -0,0 +1,39 @@
+#ifndef RUN_H_INCLUDED
+#define RUN_H_INCLUDED
+
+#include <string>
+#include <vector>
+namespace SBASIC
+{
+//Options, what the command line asked for
+struct Options
+{
+    std::string engine;
+    bool optimize;
+    bool jit;
+    bool emit_cpp;
+    std::string cpp_file_name;
+    bool cache;
+    std::string cache_directory;
+    //Shared libraries whose functions are added before parsing, in order
+    std::vector<std::string> plugins;
+    const char * file_name;
+    Options() : engine("tree"), optimize(true), jit(false), emit_cpp(false), cache(false), file_name(nullptr) {}
+};
+
+//Runs a program with one build of the core, the exit code of the interpreter
+namespace numeric_float
+{
+int run(const Options & options);
+}
+namespace numeric_double
+{
+int run(const Options & options);
+}
+namespace numeric_long_double
+{
+int run(const Options & options);
+}
+}
+
+#endif // RUN_H_INCLUDED
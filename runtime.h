@@ -0,0 +1,96 @@
+#ifndef RUNTIME_H_INCLUDED
+#define RUNTIME_H_INCLUDED
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+//What the interpreter and the C++ it generates must compute alike, --emit-cpp copies this file into its output
+//Templates on the decimal type, each build of the core and each generated program uses its own
+namespace SBASIC
+{
+//Whole-number operators, on 64-bit integers so results past 2^31 stay exact
+//Operands outside the 64-bit range, NaN and a zero divisor take the decimal path instead of overflowing
+template<typename Decimal>
+inline bool is_integer_range(Decimal sdt)
+{
+    const Decimal limit = 9223372036854775808.0L;
+    return sdt > -limit && sdt < limit;
+}
+template<typename Decimal>
+inline Decimal sbasic_divide_exactly(Decimal left,Decimal right)
+{
+    Decimal quotient = left / right;
+    //Past 2^63 a decimal is already whole
+    return is_integer_range(quotient) ? Decimal(std::int64_t(quotient)) : quotient;
+}
+template<typename Decimal>
+inline Decimal sbasic_mod(Decimal left,Decimal right)
+{
+    if(is_integer_range(left) && is_integer_range(right))
+    {
+        std::int64_t divisor = std::int64_t(right);
+        if(divisor != 0)
+        {
+            //X MOD -1 is X MOD 1, without the overflow of INT64_MIN % -1
+            return Decimal(std::int64_t(left) % (divisor == -1 ? 1 : divisor));
+        }
+    }
+    return std::fmod(std::trunc(left),std::trunc(right));
+}
+
+//Standard functions without a std:: spelling
+template<typename Decimal>
+inline Decimal sbasic_sgn(Decimal x)
+{
+    return x > 0 ? 1 : (x < 0 ? -1 : 0);
+}
+//RND(X), the next number in [0, 1) for X > 0, the last one again for X = 0, a new sequence seeded by X for X < 0
+//A 64-bit LCG whose top 24 bits are exact in every decimal type, so runs repeat everywhere
+template<typename Decimal>
+struct RndState
+{
+    static inline std::uint64_t state = 1;
+    static inline Decimal last = 0;
+};
+template<typename Decimal>
+inline Decimal sbasic_rnd(Decimal x)
+{
+    if(x == 0)
+    {
+        return RndState<Decimal>::last;
+    }
+    if(x < 0)
+    {
+        RndState<Decimal>::state = is_integer_range(x) ? std::uint64_t(-std::int64_t(x)) : 0;
+    }
+    RndState<Decimal>::state = RndState<Decimal>::state * 6364136223846793005ULL + 1442695040888963407ULL;
+    RndState<Decimal>::last = Decimal(RndState<Decimal>::state >> 40) / 16777216;
+    return RndState<Decimal>::last;
+}
+
+//PRINT of a number, the fewest digits that read back as the same number, or six significant digits as std::ostream writes them
+//Writes at most sbasic_number_size characters and returns their end
+const std::size_t sbasic_number_size = 64;
+template<typename Decimal>
+inline char * sbasic_format_number(char * text,Decimal number,bool legacy)
+{
+    if(!legacy)
+    {
+        return std::to_chars(text,text + sbasic_number_size,number).ptr;
+    }
+    if constexpr(std::is_same<Decimal,long double>::value)
+    {
+        return text + std::snprintf(text,sbasic_number_size,"%Lg",number);
+    }
+    else
+    {
+        return text + std::snprintf(text,sbasic_number_size,"%g",static_cast<double>(number));
+    }
+}
+}
+
+#endif // RUNTIME_H_INCLUDED
@@ -0,0 +1,76 @@
+#include "source.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SBASIC_SOURCE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // defined
+
+namespace SBASIC
+{
+SourceFile::SourceFile(const char * file_name) : m_data(nullptr), m_size(0), m_mapped(false)
+{
+    if(std::string(file_name) == "-")
+    {
+        m_buffer.assign(std::istreambuf_iterator<char>(std::cin),std::istreambuf_iterator<char>());
+        use_buffer();
+        return;
+    }
+#if defined SBASIC_SOURCE_MMAP
+    int fd = open(file_name,O_RDONLY);
+    if(fd < 0)
+    {
+        throw "Can not open \"" + std::string(file_name) + "\"";
+    }
+    struct stat file_stat;
+    if(fstat(fd,&file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+    {
+        void * data = mmap(nullptr,std::size_t(file_stat.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+        if(data != MAP_FAILED)
+        {
+            madvise(data,std::size_t(file_stat.st_size),MADV_SEQUENTIAL);
+            m_data = static_cast<const char *>(data);
+            m_size = std::size_t(file_stat.st_size);
+            m_mapped = true;
+            close(fd);
+            return;
+        }
+    }
+    //Pipes and other unmappable files are read in one go
+    char buffer[65536];
+    for(ssize_t count = read(fd,buffer,sizeof(buffer)); count != 0; count = read(fd,buffer,sizeof(buffer)))
+    {
+        if(count < 0)
+        {
+            close(fd);
+            throw "Can not read \"" + std::string(file_name) + "\"";
+        }
+        m_buffer.append(buffer,std::size_t(count));
+    }
+    close(fd);
+#else
+    std::ifstream ifs(file_name,std::ios::binary);
+    if(!ifs)
+    {
+        throw "Can not open \"" + std::string(file_name) + "\"";
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(ifs),std::istreambuf_iterator<char>());
+#endif // SBASIC_SOURCE_MMAP
+    use_buffer();
+}
+
+SourceFile::~SourceFile()
+{
+#if defined SBASIC_SOURCE_MMAP
+    if(m_mapped)
+    {
+        munmap(const_cast<char *>(m_data),m_size);
+    }
+#endif // SBASIC_SOURCE_MMAP
+}
+}
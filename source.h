@@ -0,0 +1,42 @@
+#ifndef SOURCE_H_INCLUDED
+#define SOURCE_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+namespace SBASIC
+{
+//SourceFile, the whole program text in memory
+class SourceFile
+{
+private:
+    const char * m_data;
+    std::size_t m_size;
+    bool m_mapped;
+    std::string m_buffer;
+    void use_buffer()
+    {
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+public:
+    //"-" reads standard input
+    SourceFile(const char * file_name);
+    SourceFile(const SourceFile &) = delete;
+    SourceFile & operator=(const SourceFile &) = delete;
+    ~SourceFile();
+    const char * begin() const
+    {
+        return m_data;
+    }
+    const char * end() const
+    {
+        return m_data + m_size;
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+};
+}
+
+#endif // SOURCE_H_INCLUDED
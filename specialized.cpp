@@ -0,0 +1,159 @@
+#include "specialized.h"
+#include <vector>
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+template<OPERATOR OP>
+Expression * create_operator_expression(Arena & arena,Expression * left_expression,Expression * right_expression)
+{
+    bool left_variable = left_expression->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION;
+    bool right_variable = right_expression->get_expression_type() == EXPRESSION::VARIABLE_EXPRESSION;
+    if(left_variable && right_expression->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION)
+    {
+        return arena.create<VariableConstantExpression<OP>>(static_cast<VariableExpression *>(left_expression),static_cast<DecimalExpression *>(right_expression));
+    }
+    else if(left_expression->get_expression_type() == EXPRESSION::DECIMAL_EXPRESSION && right_variable)
+    {
+        return arena.create<ConstantVariableExpression<OP>>(static_cast<DecimalExpression *>(left_expression),static_cast<VariableExpression *>(right_expression));
+    }
+    else if(left_variable && right_variable)
+    {
+        return arena.create<VariableVariableExpression<OP>>(static_cast<VariableExpression *>(left_expression),static_cast<VariableExpression *>(right_expression));
+    }
+    else
+    {
+        return arena.create<OperatorExpression<OP>>(left_expression,right_expression);
+    }
+}
+
+sbasic_decimal_type compute_operator(OPERATOR op,sbasic_decimal_type left,sbasic_decimal_type right)
+{
+    switch(op)
+    {
+    case OPERATOR::PLUS:
+        return Operation<OPERATOR::PLUS>::compute(left,right);
+    case OPERATOR::SUBSTRACT:
+        return Operation<OPERATOR::SUBSTRACT>::compute(left,right);
+    case OPERATOR::MULTIPLY:
+        return Operation<OPERATOR::MULTIPLY>::compute(left,right);
+    case OPERATOR::DIVIDE:
+        return Operation<OPERATOR::DIVIDE>::compute(left,right);
+    case OPERATOR::DIVIDE_EXACTLY:
+        return Operation<OPERATOR::DIVIDE_EXACTLY>::compute(left,right);
+    case OPERATOR::POWER:
+        return Operation<OPERATOR::POWER>::compute(left,right);
+    case OPERATOR::MOD:
+        return Operation<OPERATOR::MOD>::compute(left,right);
+    case OPERATOR::EQUAL:
+        return Comparison<OPERATOR::EQUAL>::test(left,right) ? sbasic_true : sbasic_false;
+    case OPERATOR::GREATER_THEN:
+        return Comparison<OPERATOR::GREATER_THEN>::test(left,right) ? sbasic_true : sbasic_false;
+    case OPERATOR::LESS_THEN:
+        return Comparison<OPERATOR::LESS_THEN>::test(left,right) ? sbasic_true : sbasic_false;
+    case OPERATOR::NOT_EQUAL:
+        return Comparison<OPERATOR::NOT_EQUAL>::test(left,right) ? sbasic_true : sbasic_false;
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+        return Comparison<OPERATOR::GREATER_THEN_OR_EQUAL>::test(left,right) ? sbasic_true : sbasic_false;
+    case OPERATOR::LESS_THEN_OR_EQUAL:
+        return Comparison<OPERATOR::LESS_THEN_OR_EQUAL>::test(left,right) ? sbasic_true : sbasic_false;
+    case OPERATOR::AND:
+    case OPERATOR::OR:
+        return right == sbasic_true ? sbasic_true : sbasic_false;
+    default:
+        throw std::string("Unknown binary operator");
+    }
+}
+
+sbasic_decimal_type ChainExpression::compute(FunctionTable & function_table,VariableTable * variable_table)
+{
+    //Left operands in order down the chain, then its last right operand, then the operators from the bottom up
+    std::vector<std::pair<OPERATOR,sbasic_decimal_type>> lefts;
+    lefts.reserve(get_chain_length());
+    Expression * exp_ptr = this;
+    sbasic_decimal_type value;
+    while(true)
+    {
+        if(exp_ptr->get_expression_type() != EXPRESSION::BINARY_EXPRESSION)
+        {
+            value = exp_ptr->compute(function_table,variable_table);
+            break;
+        }
+        BinaryExpression * binary_exp_ptr = static_cast<BinaryExpression *>(exp_ptr);
+        OPERATOR op = binary_exp_ptr->get_operator();
+        sbasic_decimal_type left = binary_exp_ptr->get_left_expression()->compute(function_table,variable_table);
+        if(is_decided(op,left))
+        {
+            value = left == sbasic_true ? sbasic_true : sbasic_false;
+            break;
+        }
+        lefts.push_back(std::make_pair(op,left));
+        exp_ptr = binary_exp_ptr->get_right_expression();
+    }
+    for(auto it = lefts.rbegin(); it != lefts.rend(); ++it)
+    {
+        value = compute_operator(it->first,it->second,value);
+    }
+    return value;
+}
+
+Expression * create_binary_expression(Arena & arena,OPERATOR op,Expression * left_expression,Expression * right_expression)
+{
+    if(right_expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION && static_cast<BinaryExpression *>(right_expression)->get_chain_length() >= MAX_NESTED_OPERATORS)
+    {
+        return arena.create<ChainExpression>(op,left_expression,right_expression);
+    }
+    switch(op)
+    {
+    case OPERATOR::PLUS:
+        return create_operator_expression<OPERATOR::PLUS>(arena,left_expression,right_expression);
+    case OPERATOR::SUBSTRACT:
+        return create_operator_expression<OPERATOR::SUBSTRACT>(arena,left_expression,right_expression);
+    case OPERATOR::MULTIPLY:
+        return create_operator_expression<OPERATOR::MULTIPLY>(arena,left_expression,right_expression);
+    case OPERATOR::DIVIDE:
+        return create_operator_expression<OPERATOR::DIVIDE>(arena,left_expression,right_expression);
+    case OPERATOR::DIVIDE_EXACTLY:
+        return create_operator_expression<OPERATOR::DIVIDE_EXACTLY>(arena,left_expression,right_expression);
+    case OPERATOR::POWER:
+        return create_operator_expression<OPERATOR::POWER>(arena,left_expression,right_expression);
+    case OPERATOR::MOD:
+        return create_operator_expression<OPERATOR::MOD>(arena,left_expression,right_expression);
+    case OPERATOR::EQUAL:
+        return create_operator_expression<OPERATOR::EQUAL>(arena,left_expression,right_expression);
+    case OPERATOR::GREATER_THEN:
+        return create_operator_expression<OPERATOR::GREATER_THEN>(arena,left_expression,right_expression);
+    case OPERATOR::LESS_THEN:
+        return create_operator_expression<OPERATOR::LESS_THEN>(arena,left_expression,right_expression);
+    case OPERATOR::NOT_EQUAL:
+        return create_operator_expression<OPERATOR::NOT_EQUAL>(arena,left_expression,right_expression);
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+        return create_operator_expression<OPERATOR::GREATER_THEN_OR_EQUAL>(arena,left_expression,right_expression);
+    case OPERATOR::LESS_THEN_OR_EQUAL:
+        return create_operator_expression<OPERATOR::LESS_THEN_OR_EQUAL>(arena,left_expression,right_expression);
+    default:
+    {
+        //AND and OR keep the generic node, their right side is evaluated lazily
+        BinaryExpression * binary_exp_ptr = arena.create<BinaryExpression>();
+        binary_exp_ptr->set_operator(op);
+        binary_exp_ptr->set_left_expression(left_expression);
+        binary_exp_ptr->set_right_expression(right_expression);
+        return binary_exp_ptr;
+    }
+    }
+}
+
+Expression * create_unary_expression(Arena & arena,OPERATOR op,Expression * expression)
+{
+    if(op == OPERATOR::SUBSTRACT)
+    {
+        return arena.create<NegateExpression>(expression);
+    }
+    UnaryExpression * unary_exp_ptr = arena.create<UnaryExpression>();
+    unary_exp_ptr->set_operator(op);
+    unary_exp_ptr->set_expression(expression);
+    return unary_exp_ptr;
+}
+}
+}
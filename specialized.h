@@ -0,0 +1,304 @@
+#ifndef SPECIALIZED_H_INCLUDED
+#define SPECIALIZED_H_INCLUDED
+
+#include <cmath>
+#include "language.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Operation, what BinaryExpression::compute does for one operator
+template<OPERATOR OP>
+struct Operation;
+
+template<>
+struct Operation<OPERATOR::PLUS>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left + right;
+    }
+};
+template<>
+struct Operation<OPERATOR::SUBSTRACT>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left - right;
+    }
+};
+template<>
+struct Operation<OPERATOR::MULTIPLY>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left * right;
+    }
+};
+template<>
+struct Operation<OPERATOR::DIVIDE>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left / right;
+    }
+};
+template<>
+struct Operation<OPERATOR::DIVIDE_EXACTLY>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return sbasic_divide_exactly(left,right);
+    }
+};
+template<>
+struct Operation<OPERATOR::POWER>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return std::pow(left,right);
+    }
+};
+template<>
+struct Operation<OPERATOR::MOD>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return sbasic_mod(left,right);
+    }
+};
+
+//Comparison, test() is the comparison and compute() its 0 or 1
+template<OPERATOR OP>
+struct Comparison;
+
+template<>
+struct Comparison<OPERATOR::EQUAL>
+{
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left == right;
+    }
+};
+template<>
+struct Comparison<OPERATOR::GREATER_THEN>
+{
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left > right;
+    }
+};
+template<>
+struct Comparison<OPERATOR::LESS_THEN>
+{
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left < right;
+    }
+};
+template<>
+struct Comparison<OPERATOR::NOT_EQUAL>
+{
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left != right;
+    }
+};
+template<>
+struct Comparison<OPERATOR::GREATER_THEN_OR_EQUAL>
+{
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left >= right;
+    }
+};
+template<>
+struct Comparison<OPERATOR::LESS_THEN_OR_EQUAL>
+{
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return left <= right;
+    }
+};
+
+//Arithmetic and comparison share the node templates through compute() and test()
+template<OPERATOR OP,bool IS_COMPARISON>
+struct OperationTraits
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return Operation<OP>::compute(left,right);
+    }
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return Operation<OP>::compute(left,right) == sbasic_true;
+    }
+};
+template<OPERATOR OP>
+struct OperationTraits<OP,true>
+{
+    static sbasic_decimal_type compute(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return Comparison<OP>::test(left,right) ? sbasic_true : sbasic_false;
+    }
+    static bool test(sbasic_decimal_type left,sbasic_decimal_type right)
+    {
+        return Comparison<OP>::test(left,right);
+    }
+};
+constexpr bool is_comparison(OPERATOR op)
+{
+    return op == OPERATOR::EQUAL || op == OPERATOR::GREATER_THEN || op == OPERATOR::LESS_THEN || op == OPERATOR::NOT_EQUAL || op == OPERATOR::GREATER_THEN_OR_EQUAL || op == OPERATOR::LESS_THEN_OR_EQUAL;
+}
+
+//Specialized binary nodes, still BinaryExpressions to every pass that walks the tree
+//Operands are computed left first, like BinaryExpression
+template<OPERATOR OP>
+class OperatorExpression : public BinaryExpression
+{
+private:
+    typedef OperationTraits<OP,is_comparison(OP)> Traits;
+public:
+    OperatorExpression(Expression * left_expression,Expression * right_expression)
+    {
+        set_operator(OP);
+        set_left_expression(left_expression);
+        set_right_expression(right_expression);
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        sbasic_decimal_type left = get_left_expression()->compute(function_table,variable_table);
+        return Traits::compute(left,get_right_expression()->compute(function_table,variable_table));
+    }
+    bool test(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        sbasic_decimal_type left = get_left_expression()->compute(function_table,variable_table);
+        return Traits::test(left,get_right_expression()->compute(function_table,variable_table));
+    }
+};
+
+//Variable op constant
+template<OPERATOR OP>
+class VariableConstantExpression : public BinaryExpression
+{
+private:
+    typedef OperationTraits<OP,is_comparison(OP)> Traits;
+    VariableExpression * m_variable_expression;
+    sbasic_decimal_type m_constant;
+public:
+    VariableConstantExpression(VariableExpression * left_expression,DecimalExpression * right_expression) : m_variable_expression(left_expression), m_constant(right_expression->get_decimal())
+    {
+        set_operator(OP);
+        set_left_expression(left_expression);
+        set_right_expression(right_expression);
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return Traits::compute(m_variable_expression->VariableExpression::compute(function_table,variable_table),m_constant);
+    }
+    bool test(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return Traits::test(m_variable_expression->VariableExpression::compute(function_table,variable_table),m_constant);
+    }
+};
+
+//Constant op variable
+template<OPERATOR OP>
+class ConstantVariableExpression : public BinaryExpression
+{
+private:
+    typedef OperationTraits<OP,is_comparison(OP)> Traits;
+    sbasic_decimal_type m_constant;
+    VariableExpression * m_variable_expression;
+public:
+    ConstantVariableExpression(DecimalExpression * left_expression,VariableExpression * right_expression) : m_constant(left_expression->get_decimal()), m_variable_expression(right_expression)
+    {
+        set_operator(OP);
+        set_left_expression(left_expression);
+        set_right_expression(right_expression);
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return Traits::compute(m_constant,m_variable_expression->VariableExpression::compute(function_table,variable_table));
+    }
+    bool test(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return Traits::test(m_constant,m_variable_expression->VariableExpression::compute(function_table,variable_table));
+    }
+};
+
+//Variable op variable
+template<OPERATOR OP>
+class VariableVariableExpression : public BinaryExpression
+{
+private:
+    typedef OperationTraits<OP,is_comparison(OP)> Traits;
+    VariableExpression * m_left_variable_expression;
+    VariableExpression * m_right_variable_expression;
+public:
+    VariableVariableExpression(VariableExpression * left_expression,VariableExpression * right_expression) : m_left_variable_expression(left_expression), m_right_variable_expression(right_expression)
+    {
+        set_operator(OP);
+        set_left_expression(left_expression);
+        set_right_expression(right_expression);
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        sbasic_decimal_type left = m_left_variable_expression->VariableExpression::compute(function_table,variable_table);
+        return Traits::compute(left,m_right_variable_expression->VariableExpression::compute(function_table,variable_table));
+    }
+    bool test(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        sbasic_decimal_type left = m_left_variable_expression->VariableExpression::compute(function_table,variable_table);
+        return Traits::test(left,m_right_variable_expression->VariableExpression::compute(function_table,variable_table));
+    }
+};
+
+//What BinaryExpression::compute gives for any operator, AND and OR once their left operand did not decide
+sbasic_decimal_type compute_operator(OPERATOR op,sbasic_decimal_type left,sbasic_decimal_type right);
+//Whether the left operand of AND or OR decides the value, the right one is then never computed
+inline bool is_decided(OPERATOR op,sbasic_decimal_type left)
+{
+    return (op == OPERATOR::AND && left != sbasic_true) || (op == OPERATOR::OR && left == sbasic_true);
+}
+
+//A chain of more than MAX_NESTED_OPERATORS operators, computed in a loop rather than one call per operator
+//Only the top of a chain is ever computed, the nodes below it are walked
+class ChainExpression : public BinaryExpression
+{
+public:
+    ChainExpression(OPERATOR op,Expression * left_expression,Expression * right_expression)
+    {
+        set_operator(op);
+        set_left_expression(left_expression);
+        set_right_expression(right_expression);
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table);
+    bool test(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return compute(function_table,variable_table) == sbasic_true;
+    }
+};
+
+//Negation, the only unary operator worth a node of its own
+class NegateExpression : public UnaryExpression
+{
+public:
+    NegateExpression(Expression * expression)
+    {
+        set_operator(OPERATOR::SUBSTRACT);
+        set_expression(expression);
+    }
+    sbasic_decimal_type compute(FunctionTable & function_table,VariableTable * variable_table)
+    {
+        return -(get_expression()->compute(function_table,variable_table));
+    }
+};
+
+//Factory function, picks the specialized node for an operator and its operands
+Expression * create_binary_expression(Arena & arena,OPERATOR op,Expression * left_expression,Expression * right_expression);
+Expression * create_unary_expression(Arena & arena,OPERATOR op,Expression * expression);
+}
+}
+
+#endif // SPECIALIZED_H_INCLUDED
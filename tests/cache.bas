@@ -0,0 +1,11 @@
+REM Read back from the cache, where PARSED is renamed LOADED to tell a loaded run from a parsed one
+N = 0
+WHILE N < 3
+    IF N = 1 THEN
+        M = N
+    END IF
+    N = N + 1
+WEND
+PRINT N
+PRINT PARSED
+END
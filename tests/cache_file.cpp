@@ -0,0 +1,110 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+//Prepares and alters the cache file of a --cache=<directory> run, so tests can tell a loaded cache from a parsed program
+//sbasic_cache_file <directory> clean             removes the cache files, creating the directory
+//sbasic_cache_file <directory> rename <from> <to> renames a variable in the only cache file, every use of it, both names of one length
+//sbasic_cache_file <directory> truncate <size>   cuts the only cache file to size bytes
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static bool cache_file(const fs::path & directory,fs::path & file)
+{
+    int count = 0;
+    for(const fs::directory_entry & entry : fs::directory_iterator(directory))
+    {
+        if(entry.path().extension() == ".sbc")
+        {
+            file = entry.path();
+            ++count;
+        }
+    }
+    if(count != 1)
+    {
+        cout << "Found " << count << " cache files in " << directory << " instead of one" << endl;
+        return false;
+    }
+    return true;
+}
+
+//Names are written as a 4 byte little endian length and the bytes, in the table and at every use
+static string cached_name(const string & name)
+{
+    string bytes;
+    for(int i = 0; i < 4; ++i)
+    {
+        bytes += char((name.size() >> (8 * i)) & 0xFF);
+    }
+    return bytes + name;
+}
+
+int main(int argc,char * argv[])
+{
+    if(argc < 3)
+    {
+        cout << "Usage: sbasic_cache_file <directory> clean | rename <from> <to> | truncate <size>" << endl;
+        return 1;
+    }
+    fs::path directory(argv[1]);
+    string command(argv[2]);
+    try
+    {
+        if(command == "clean" && argc == 3)
+        {
+            fs::create_directories(directory);
+            for(const fs::directory_entry & entry : fs::directory_iterator(directory))
+            {
+                fs::remove(entry.path());
+            }
+            return 0;
+        }
+        fs::path file;
+        if(!cache_file(directory,file))
+        {
+            return 1;
+        }
+        if(command == "truncate" && argc == 4)
+        {
+            fs::resize_file(file,stoull(argv[3]));
+            return 0;
+        }
+        if(command == "rename" && argc == 5 && string(argv[3]).size() == string(argv[4]).size())
+        {
+            string bytes;
+            {
+                ifstream input(file,ios::binary);
+                bytes.assign(istreambuf_iterator<char>(input),istreambuf_iterator<char>());
+            }
+            string from = cached_name(argv[3]);
+            string::size_type position = bytes.find(from);
+            if(position == string::npos)
+            {
+                cout << "No variable " << argv[3] << " in " << file << endl;
+                return 1;
+            }
+            string to = cached_name(argv[4]);
+            for(; position != string::npos; position = bytes.find(from,position + to.size()))
+            {
+                bytes.replace(position,from.size(),to);
+            }
+            ofstream output(file,ios::binary | ios::trunc);
+            if(!(output << bytes))
+            {
+                cout << "Can not write " << file << endl;
+                return 1;
+            }
+            return 0;
+        }
+    }
+    catch(fs::filesystem_error & err)
+    {
+        cout << err.what() << endl;
+        return 1;
+    }
+    cout << "Unknown command " << command << endl;
+    return 1;
+}
@@ -0,0 +1,24 @@
+#Runs SBASIC and compares what it prints with a file, or looks for a message in it
+#cmake -DSBASIC=<SBASIC> -DOPTIONS=<options> -DPROGRAM=<program.bas> -DEXPECTED=<expected.txt> -P check_output.cmake
+#cmake -DSBASIC=<SBASIC> -DOPTIONS=<options> -DPROGRAM=<program.bas> -DMESSAGE=<text> -P check_output.cmake
+#Without PROGRAM SBASIC is a script built by sbasic_add_executable
+separate_arguments(OPTIONS)
+execute_process(COMMAND ${SBASIC} ${OPTIONS} ${PROGRAM}
+    OUTPUT_VARIABLE OUTPUT
+    ERROR_VARIABLE OUTPUT
+    RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "SBASIC ${OPTIONS} ${PROGRAM} failed: ${RESULT}\n${OUTPUT}")
+endif()
+if(DEFINED MESSAGE)
+    #Error messages go on with details from the system
+    string(FIND "${OUTPUT}" "${MESSAGE}" POSITION)
+    if(POSITION EQUAL -1)
+        message(FATAL_ERROR "SBASIC ${OPTIONS} ${PROGRAM} printed\n${OUTPUT}\nwithout\n${MESSAGE}")
+    endif()
+    return()
+endif()
+file(READ ${EXPECTED} EXPECTED_OUTPUT)
+if(NOT OUTPUT STREQUAL EXPECTED_OUTPUT)
+    message(FATAL_ERROR "SBASIC ${OPTIONS} ${PROGRAM} printed\n${OUTPUT}\ninstead of\n${EXPECTED_OUTPUT}")
+endif()
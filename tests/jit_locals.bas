@@ -0,0 +1,32 @@
+REM Hot loops creating variables of their own, T, U and V are gone after each iteration
+I = 0
+S = 0
+WHILE I < 20000
+    T = I * I
+    IF T MOD 3 = 0 THEN
+        U = 1
+        S = S + U
+    ELSE
+        S = S + T MOD 7
+    END IF
+    I = I + 1
+WEND
+PRINT S
+K = 0
+DO
+    V = K + 1
+    K = V
+LOOP UNTIL K >= 2000
+PRINT K
+REM Written on no path the loop takes, it keeps its value
+W = 7
+J = 0
+WHILE J < 2000
+    IF J < 0 THEN
+        W = 1
+    END IF
+    J = J + 1
+WEND
+PRINT W
+PRINT T
+END
@@ -0,0 +1,87 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "runtime.h"
+
+//Writes a program of millions of lines and chains of hundreds of thousands of operators, and what it prints
+//sbasic_stress <program.bas> <expected.txt>
+
+using namespace std;
+
+//IF ... END IF groups of six lines
+const long GROUPS = 400000;
+//Operators in the longest chains
+const long CHAIN = 1000000;
+const long VARIABLE_CHAIN = 300000;
+//A chain computed in a hot loop, long enough to be computed in one node
+const long LOOP_CHAIN = 1000;
+const long LOOP_ITERATIONS = 2000;
+
+static void expect(ostream & expected,double number)
+{
+    char text[SBASIC::sbasic_number_size];
+    expected << string(text,SBASIC::sbasic_format_number(text,number,false)) << '\n';
+}
+
+static void chain(ostream & program,const string & first,const string & op,const string & operand,long count)
+{
+    program << first;
+    for(long i = 0; i < count; ++i)
+    {
+        program << ' ' << op << ' ' << operand;
+    }
+}
+
+int main(int argc,char * argv[])
+{
+    if(argc != 3)
+    {
+        cout << "Usage: sbasic_stress <program.bas> <expected.txt>" << endl;
+        return 1;
+    }
+    ofstream program(argv[1]);
+    ofstream expected(argv[2]);
+    program << "REM Generated by sbasic_stress\n";
+    program << "I = 0\nS = 0\n";
+    double sum = 0;
+    for(long i = 0; i < GROUPS; ++i)
+    {
+        program << "IF I MOD 2 = 0 THEN\n    S = S + I\nELSE\n    S = S - 1\nEND IF\nI = I + 1\n";
+        sum += i % 2 == 0 ? i : -1;
+    }
+    program << "PRINT S\n";
+    expect(expected,sum);
+    //Folded by the optimizer
+    chain(program,"T = 0","+","1",CHAIN);
+    program << "\nPRINT T\n";
+    expect(expected,CHAIN);
+    //Left to the engines
+    chain(program,"U = I","+","I",VARIABLE_CHAIN);
+    program << "\nPRINT U\n";
+    expect(expected,double(GROUPS) * (VARIABLE_CHAIN + 1));
+    //Operators associate to the right, I - (I - (I - ... I)) is I for an odd number of operands
+    chain(program,"W = I","-","I",VARIABLE_CHAIN);
+    program << "\nPRINT W\n";
+    expect(expected,VARIABLE_CHAIN % 2 == 0 ? GROUPS : 0);
+    //AND and OR decided by the last operand, then by the first, Z is never defined
+    chain(program,"A = I > 0","AND","I > 0",VARIABLE_CHAIN);
+    program << "\nPRINT A\n";
+    expect(expected,1);
+    chain(program,"B = I < 0","OR","I < 0",VARIABLE_CHAIN);
+    program << " OR I > 0\nPRINT B\n";
+    expect(expected,1);
+    chain(program,"C = I < 0","AND","Z",VARIABLE_CHAIN);
+    program << "\nPRINT C\n";
+    expect(expected,0);
+    program << "K = 0\nWHILE K < " << LOOP_ITERATIONS << "\n";
+    chain(program,"    K = K + 1","+","(I - I)",LOOP_CHAIN);
+    program << "\nWEND\nPRINT K\n";
+    expect(expected,LOOP_ITERATIONS);
+    program << "END\n";
+    if(!program || !expected)
+    {
+        cout << "Can not write the stress program" << endl;
+        return 1;
+    }
+    return 0;
+}
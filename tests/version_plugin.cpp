@@ -0,0 +1,19 @@
+#include "plugin.h"
+
+//A plugin built against another version of the interface, SBASIC refuses to load it
+
+static double twice(double x)
+{
+    return x * 2;
+}
+
+static const sbasic_plugin_function FUNCTIONS[] =
+{
+    SBASIC::plugin_function<&twice>("TWICE")
+};
+
+extern "C" SBASIC_PLUGIN_EXPORT const sbasic_plugin * sbasic_plugin_entry()
+{
+    static const sbasic_plugin plugin = {SBASIC_PLUGIN_VERSION + 1,sizeof(FUNCTIONS) / sizeof(FUNCTIONS[0]),FUNCTIONS};
+    return &plugin;
+}
@@ -0,0 +1,519 @@
+#include "transpiler.h"
+#include "specialized.h"
+#include "runtime_text.h"
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+#if defined SBASIC_DECIMAL_TYPE_LONG_DOUBLE
+const char * const DECIMAL_TYPE_NAME = "long double";
+const char * const DECIMAL_SUFFIX = "L";
+#elif defined SBASIC_DECIMAL_TYPE_FLOAT
+const char * const DECIMAL_TYPE_NAME = "float";
+const char * const DECIMAL_SUFFIX = "f";
+#elif defined SBASIC_DECIMAL_TYPE_DOUBLE
+const char * const DECIMAL_TYPE_NAME = "double";
+const char * const DECIMAL_SUFFIX = "";
+#endif // SBASIC_DECIMAL_TYPE_LONG_DOUBLE
+
+//Runtime support, what is not in runtime.h is particular to generated programs
+const char * const PRELUDE =
+    "#include <initializer_list>\n"
+    "#include <iostream>\n"
+    "#include <limits>\n"
+    "#include <string>\n"
+    "\n"
+    "using namespace SBASIC;\n"
+    "inline sbasic_decimal_type sbasic_boolean(bool b)\n"
+    "{\n"
+    "    return b ? 1 : 0;\n"
+    "}\n"
+    "[[noreturn]] inline sbasic_decimal_type sbasic_error(const char * message)\n"
+    "{\n"
+    "    throw std::string(message);\n"
+    "}\n"
+    "//Arguments are computed left first before the error, like a call in the interpreter\n"
+    "[[noreturn]] inline sbasic_decimal_type sbasic_function_not_found(const char * message,std::initializer_list<sbasic_decimal_type>)\n"
+    "{\n"
+    "    throw std::string(message);\n"
+    "}\n"
+    "inline void sbasic_print(sbasic_decimal_type x)\n"
+    "{\n"
+    "    char text[sbasic_number_size + 1];\n"
+    "    char * end = sbasic_format_number(text,x,SBASIC_LEGACY_FORMAT);\n"
+    "    *end = '\\n';\n"
+    "    std::cout.write(text,end + 1 - text);\n"
+    "}\n"
+    "\n";
+const char * const MAIN =
+    "int main()\n"
+    "{\n"
+    "    try\n"
+    "    {\n"
+    "        sbasic_run();\n"
+    "    }\n"
+    "    catch(std::string & err)\n"
+    "    {\n"
+    "        std::cout << err << std::endl;\n"
+    "    }\n"
+    "    return 0;\n"
+    "}\n";
+
+void Transpiler::transpile(const Program * program,const std::string & source_name,std::ostream & out)
+{
+    VariableTable variable_table(program->get_variable_count());
+    m_variable_table = &variable_table;
+    m_out = &out;
+    m_indent = 1;
+    out << "//Generated by SBASIC from " << source_name << "\n";
+    out << "typedef " << DECIMAL_TYPE_NAME << " sbasic_decimal_type;\n";
+    out << "#define SBASIC_LEGACY_FORMAT " << (m_number_format == NUMBER_FORMAT::LEGACY ? "true" : "false") << "\n";
+    out << RUNTIME_TEXT << "\n";
+    out << PRELUDE;
+    out << "static void sbasic_run()\n{\n";
+    stmts(program->get_stmts());
+    out << "}\n\n" << MAIN;
+    m_variable_table = nullptr;
+    m_out = nullptr;
+}
+
+std::ostream & Transpiler::line()
+{
+    for(unsigned int i = 0; i < m_indent; ++i)
+    {
+        *m_out << "    ";
+    }
+    return *m_out;
+}
+void Transpiler::stmts(const NodeList<Stmt *> & stmts)
+{
+    for(auto it = stmts.begin(); it != stmts.end(); ++it)
+    {
+        stmt(*it);
+    }
+}
+//A C++ block, its locals go out of scope exactly when the variables it created would be forgotten
+void Transpiler::block(const NodeList<Stmt *> & stmts)
+{
+    std::size_t block = m_variable_table->mark();
+    line() << "{\n";
+    ++m_indent;
+    this->stmts(stmts);
+    --m_indent;
+    line() << "}\n";
+    m_variable_table->reset(block);
+}
+void Transpiler::stmt(const Stmt * stmt)
+{
+    switch(stmt->get_stmt_type())
+    {
+    case STMT::PRINT_STMT:
+    {
+        const PrintStmt * print_stmt_ptr = static_cast<const PrintStmt *>(stmt);
+        if(print_stmt_ptr->has_prompt())
+        {
+            line() << "std::cout << " << quote(print_stmt_ptr->get_prompt()) << " << '\\n';\n";
+        }
+        const NodeList<Expression *> & exps = print_stmt_ptr->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            line() << "sbasic_print(" << value(*it) << ");\n";
+        }
+        break;
+    }
+    case STMT::INPUT_STMT:
+    {
+        const InputStmt * input_stmt_ptr = static_cast<const InputStmt *>(stmt);
+        line() << "std::cout << " << quote(input_stmt_ptr->has_prompt() ? input_stmt_ptr->get_prompt() + "?" : "?") << ";\n";
+        const NodeList<VariableExpression *> & exps = input_stmt_ptr->get_expressions();
+        for(auto it = exps.begin(); it != exps.end(); ++it)
+        {
+            if(!m_variable_table->is_defined((**it).get_slot()))
+            {
+                line() << "sbasic_decimal_type " << variable_name(*it) << ";\n";
+                m_variable_table->assign_variable((**it).get_slot(),sbasic_false);
+            }
+            line() << "std::cin >> " << variable_name(*it) << ";\n";
+        }
+        break;
+    }
+    case STMT::ASSIGNMENT_STMT:
+    {
+        const AssignmentStmt * assignment_stmt_ptr = static_cast<const AssignmentStmt *>(stmt);
+        assign(assignment_stmt_ptr->get_variable_expression(),value(assignment_stmt_ptr->get_expression()));
+        break;
+    }
+    case STMT::SELECTION_STMT:
+    {
+        const SelectionStmt * selection_stmt_ptr = static_cast<const SelectionStmt *>(stmt);
+        line() << "if(" << test(selection_stmt_ptr->get_condition()) << ")\n";
+        block(selection_stmt_ptr->get_true_stmts());
+        if(!selection_stmt_ptr->get_false_stmts().empty())
+        {
+            line() << "else\n";
+            block(selection_stmt_ptr->get_false_stmts());
+        }
+        break;
+    }
+    case STMT::WHILE_ITERATOR_STMT:
+    {
+        const WHILEIteratorStmt * while_stmt_ptr = static_cast<const WHILEIteratorStmt *>(stmt);
+        line() << "while(" << test(while_stmt_ptr->get_condition()) << ")\n";
+        block(while_stmt_ptr->get_stmts());
+        break;
+    }
+    case STMT::DO_ITERATOR_STMT:
+    {
+        //The condition is outside the body, it sees none of the variables the body created
+        const DOIteratorStmt * do_stmt_ptr = static_cast<const DOIteratorStmt *>(stmt);
+        line() << "do\n";
+        block(do_stmt_ptr->get_stmts());
+        line() << "while(" << until(do_stmt_ptr->get_condition()) << ");\n";
+        break;
+    }
+    case STMT::BLOCK_STMT:
+        block(static_cast<const BlockStmt *>(stmt)->get_stmts());
+        break;
+    }
+}
+void Transpiler::assign(const VariableExpression * variable_expression,const std::string & value)
+{
+    if(m_variable_table->is_defined(variable_expression->get_slot()))
+    {
+        line() << variable_name(variable_expression) << " = " << value << ";\n";
+    }
+    else
+    {
+        //Created here
+        line() << "sbasic_decimal_type " << variable_name(variable_expression) << " = " << value << ";\n";
+        m_variable_table->assign_variable(variable_expression->get_slot(),sbasic_false);
+    }
+}
+
+//A C++ expression of type sbasic_decimal_type
+std::string Transpiler::value(const Expression * expression)
+{
+    switch(expression->get_expression_type())
+    {
+    case EXPRESSION::DECIMAL_EXPRESSION:
+        return decimal(static_cast<const DecimalExpression *>(expression)->get_decimal());
+    case EXPRESSION::VARIABLE_EXPRESSION:
+    {
+        const VariableExpression * variable_exp_ptr = static_cast<const VariableExpression *>(expression);
+        if(m_variable_table->is_defined(variable_exp_ptr->get_slot()))
+        {
+            return variable_name(variable_exp_ptr);
+        }
+        return "sbasic_error(" + quote("Line: " + std::to_string(variable_exp_ptr->get_line_number()) + ", Error: The \"" + variable_exp_ptr->get_variable_name() + "\" variable not found") + ")";
+    }
+    case EXPRESSION::UNARY_EXPRESSION:
+    {
+        const UnaryExpression * unary_exp_ptr = static_cast<const UnaryExpression *>(expression);
+        if(unary_exp_ptr->get_operator() == OPERATOR::PLUS)
+        {
+            return value(unary_exp_ptr->get_expression());
+        }
+        else if(unary_exp_ptr->get_operator() == OPERATOR::SUBSTRACT)
+        {
+            return "(-" + value(unary_exp_ptr->get_expression()) + ")";
+        }
+        return "sbasic_boolean(" + test(expression) + ")";
+    }
+    case EXPRESSION::BINARY_EXPRESSION:
+    {
+        const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(expression);
+        if(binary_exp_ptr->get_chain_length() > MAX_NESTED_OPERATORS)
+        {
+            return chain(binary_exp_ptr);
+        }
+        if(binary_exp_ptr->is_boolean())
+        {
+            return "sbasic_boolean(" + test(expression) + ")";
+        }
+        return binary(binary_exp_ptr,"sbasic_decimal_type");
+    }
+    case EXPRESSION::CALL_EXPRESSION:
+        return call(static_cast<const CallExpression *>(expression));
+    }
+    return std::string();
+}
+//A C++ expression of type bool, what Expression::test() returns
+std::string Transpiler::test(const Expression * expression)
+{
+    if(expression->get_expression_type() == EXPRESSION::UNARY_EXPRESSION && static_cast<const UnaryExpression *>(expression)->get_operator() == OPERATOR::NOT)
+    {
+        const Expression * exp_ptr = static_cast<const UnaryExpression *>(expression)->get_expression();
+        if(exp_ptr->is_boolean())
+        {
+            return "!" + test(exp_ptr);
+        }
+        return "(" + value(exp_ptr) + " == 0)";
+    }
+    if(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION && static_cast<const BinaryExpression *>(expression)->get_chain_length() <= MAX_NESTED_OPERATORS)
+    {
+        const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(expression);
+        if(binary_exp_ptr->get_operator() == OPERATOR::AND)
+        {
+            return "(" + test(binary_exp_ptr->get_left_expression()) + " && " + test(binary_exp_ptr->get_right_expression()) + ")";
+        }
+        else if(binary_exp_ptr->get_operator() == OPERATOR::OR)
+        {
+            return "(" + test(binary_exp_ptr->get_left_expression()) + " || " + test(binary_exp_ptr->get_right_expression()) + ")";
+        }
+        else if(is_comparison(binary_exp_ptr->get_operator()))
+        {
+            return binary(binary_exp_ptr,"bool");
+        }
+    }
+    return "(" + value(expression) + " == 1)";
+}
+//Whether DO...LOOP UNTIL goes round again
+std::string Transpiler::until(const Expression * expression)
+{
+    if(expression->is_boolean())
+    {
+        return "!" + test(expression);
+    }
+    return "(" + value(expression) + " == 0)";
+}
+//The operands of C++ operators are unsequenced, when both sides can raise an error the left one is computed first explicitly
+std::string Transpiler::binary(const BinaryExpression * binary_expression,const std::string & type)
+{
+    const Expression * left_expression = binary_expression->get_left_expression();
+    const Expression * right_expression = binary_expression->get_right_expression();
+    bool sequenced = can_throw(left_expression) && can_throw(right_expression);
+    std::string left = value(left_expression);
+    std::string right = value(right_expression);
+    std::string operand = sequenced ? "left" : left;
+    std::string result = operation(binary_expression->get_operator(),operand,right);
+    if(sequenced)
+    {
+        return "[&]() -> " + type + " { sbasic_decimal_type left = " + left + "; return " + result + "; }()";
+    }
+    return result;
+}
+//A C++ expression of the operator applied to two C++ expressions, comparisons are bool
+std::string Transpiler::operation(OPERATOR op,const std::string & left,const std::string & right) const
+{
+    switch(op)
+    {
+    case OPERATOR::PLUS:
+        return "(" + left + " + " + right + ")";
+    case OPERATOR::SUBSTRACT:
+        return "(" + left + " - " + right + ")";
+    case OPERATOR::MULTIPLY:
+        return "(" + left + " * " + right + ")";
+    case OPERATOR::DIVIDE:
+        return "(" + left + " / " + right + ")";
+    case OPERATOR::DIVIDE_EXACTLY:
+        return "sbasic_divide_exactly(" + left + ", " + right + ")";
+    case OPERATOR::POWER:
+        return "std::pow(" + left + ", " + right + ")";
+    case OPERATOR::MOD:
+        return "sbasic_mod(" + left + ", " + right + ")";
+    case OPERATOR::EQUAL:
+        return "(" + left + " == " + right + ")";
+    case OPERATOR::GREATER_THEN:
+        return "(" + left + " > " + right + ")";
+    case OPERATOR::LESS_THEN:
+        return "(" + left + " < " + right + ")";
+    case OPERATOR::NOT_EQUAL:
+        return "(" + left + " != " + right + ")";
+    case OPERATOR::GREATER_THEN_OR_EQUAL:
+        return "(" + left + " >= " + right + ")";
+    case OPERATOR::LESS_THEN_OR_EQUAL:
+        return "(" + left + " <= " + right + ")";
+    default:
+        return std::string();
+    }
+}
+//Every operator would nest its right operand in C++ too, past MAX_NESTED_OPERATORS compilers give up
+//So a long chain is a lambda of one statement per operator, like ChainExpression: left operands down the chain, then the operators from the bottom up
+//BASIC has no recursion, the lambda is never entered again before it returns and its operands can be static
+std::string Transpiler::chain(const BinaryExpression * binary_expression)
+{
+    std::string code = "[&]() -> sbasic_decimal_type { static sbasic_decimal_type left[" + std::to_string(binary_expression->get_chain_length()) + "]; sbasic_decimal_type right; ";
+    std::vector<OPERATOR> ops;
+    const Expression * exp_ptr = binary_expression;
+    while(exp_ptr->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        const BinaryExpression * binary_exp_ptr = static_cast<const BinaryExpression *>(exp_ptr);
+        std::string index = std::to_string(ops.size());
+        ops.push_back(binary_exp_ptr->get_operator());
+        if(ops.back() == OPERATOR::AND)
+        {
+            code += "if(!" + test(binary_exp_ptr->get_left_expression()) + ") { right = 0; goto decided" + index + "; } ";
+        }
+        else if(ops.back() == OPERATOR::OR)
+        {
+            code += "if(" + test(binary_exp_ptr->get_left_expression()) + ") { right = 1; goto decided" + index + "; } ";
+        }
+        else
+        {
+            code += "left[" + index + "] = " + value(binary_exp_ptr->get_left_expression()) + "; ";
+        }
+        exp_ptr = binary_exp_ptr->get_right_expression();
+    }
+    code += "right = " + value(exp_ptr) + "; ";
+    for(std::size_t i = ops.size(); i-- > 0;)
+    {
+        std::string index = std::to_string(i);
+        if(ops[i] == OPERATOR::AND || ops[i] == OPERATOR::OR)
+        {
+            code += "right = sbasic_boolean(right == 1); decided" + index + ": ; ";
+        }
+        else if(is_comparison(ops[i]))
+        {
+            code += "right = sbasic_boolean(" + operation(ops[i],"left[" + index + "]","right") + "); ";
+        }
+        else
+        {
+            code += "right = " + operation(ops[i],"left[" + index + "]","right") + "; ";
+        }
+    }
+    return code + "return right; }()";
+}
+std::string Transpiler::call(const CallExpression * call_expression)
+{
+    const NodeList<Expression *> & exps = call_expression->get_expressions();
+    const Function * function = call_expression->get_function();
+    std::vector<std::string> args;
+    std::size_t throwing = 0;
+    for(auto it = exps.begin(); it != exps.end(); ++it)
+    {
+        args.push_back(value(*it));
+        throwing += can_throw(*it) ? 1 : 0;
+    }
+    std::string arg_list;
+    for(std::size_t i = 0; i < args.size(); ++i)
+    {
+        arg_list += (i == 0 ? "" : ", ") + args[i];
+    }
+    if(function == nullptr)
+    {
+        //A braced list computes its elements in order
+        return "sbasic_function_not_found(" + quote("The \"" + call_expression->get_function_name() + "\" function not found") + ", {" + arg_list + "})";
+    }
+    if(function->cpp_name == nullptr)
+    {
+        throw "Line: " + std::to_string(call_expression->get_line_number()) + ", Error: The \"" + call_expression->get_function_name() + "\" function can not be transpiled";
+    }
+    if(throwing < 2)
+    {
+        return std::string(function->cpp_name) + "(" + arg_list + ")";
+    }
+    //Arguments of a C++ call are unsequenced, when several can raise an error they are computed in order first
+    std::string sequenced = "[&]() -> sbasic_decimal_type { ";
+    arg_list.clear();
+    for(std::size_t i = 0; i < args.size(); ++i)
+    {
+        sequenced += "sbasic_decimal_type arg" + std::to_string(i) + " = " + args[i] + "; ";
+        arg_list += (i == 0 ? "" : ", ") + ("arg" + std::to_string(i));
+    }
+    return sequenced + "return " + function->cpp_name + "(" + arg_list + "); }()";
+}
+bool Transpiler::can_throw(const Expression * expression) const
+{
+    while(expression->get_expression_type() == EXPRESSION::BINARY_EXPRESSION)
+    {
+        if(can_throw(static_cast<const BinaryExpression *>(expression)->get_left_expression()))
+        {
+            return true;
+        }
+        expression = static_cast<const BinaryExpression *>(expression)->get_right_expression();
+    }
+    switch(expression->get_expression_type())
+    {
+    case EXPRESSION::VARIABLE_EXPRESSION:
+        return !m_variable_table->is_defined(static_cast<const VariableExpression *>(expression)->get_slot());
+    case EXPRESSION::UNARY_EXPRESSION:
+        return can_throw(static_cast<const UnaryExpression *>(expression)->get_expression());
+    case EXPRESSION::CALL_EXPRESSION:
+    {
+        const CallExpression * call_exp_ptr = static_cast<const CallExpression *>(expression);
+        if(call_exp_ptr->get_function() == nullptr)
+        {
+            return true;
+        }
+        for(auto it = call_exp_ptr->get_expressions().begin(); it != call_exp_ptr->get_expressions().end(); ++it)
+        {
+            if(can_throw(*it))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    default:
+        return false;
+    }
+}
+
+//Names may contain '.', which becomes '_', a character SBASIC names never have
+std::string Transpiler::variable_name(const VariableExpression * variable_expression) const
+{
+    std::string name = "v_" + variable_expression->get_variable_name();
+    for(auto it = name.begin(); it != name.end(); ++it)
+    {
+        if(*it == '.')
+        {
+            *it = '_';
+        }
+    }
+    return name;
+}
+//Exact, the literal reads back as the same value
+std::string Transpiler::decimal(sbasic_decimal_type decimal) const
+{
+    std::string sign = std::signbit(decimal) ? "-" : "";
+    if(std::isnan(decimal))
+    {
+        return "(" + sign + "std::numeric_limits<sbasic_decimal_type>::quiet_NaN())";
+    }
+    if(std::isinf(decimal))
+    {
+        return "(" + sign + "std::numeric_limits<sbasic_decimal_type>::infinity())";
+    }
+    std::ostringstream stream;
+    stream << std::setprecision(std::numeric_limits<sbasic_decimal_type>::max_digits10) << decimal;
+    std::string text = stream.str();
+    if(text.find_first_of(".e") == std::string::npos)
+    {
+        text += ".0";
+    }
+    text += DECIMAL_SUFFIX;
+    return sign.empty() ? text : "(" + text + ")";
+}
+std::string Transpiler::quote(const std::string & str) const
+{
+    std::string text = "\"";
+    for(auto it = str.begin(); it != str.end(); ++it)
+    {
+        unsigned char c = *it;
+        if(c == '"' || c == '\\')
+        {
+            text += '\\';
+            text += char(c);
+        }
+        else if(c < 0x20 || c >= 0x7F)
+        {
+            const char digits[] = "01234567";
+            text += '\\';
+            text += digits[(c >> 6) & 7];
+            text += digits[(c >> 3) & 7];
+            text += digits[c & 7];
+        }
+        else
+        {
+            text += char(c);
+        }
+    }
+    return text + "\"";
+}
+}
+}
@@ -0,0 +1,47 @@
+#ifndef TRANSPILER_H_INCLUDED
+#define TRANSPILER_H_INCLUDED
+
+#include <ostream>
+#include <string>
+#include "language.h"
+#include "output.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//Transpiler, writes a program as one self-contained C++ translation unit
+//A block forgets the variables it creates, so whether a variable is defined is known statically:
+//variables become C++ locals declared where they are created, and reads of undefined ones become the error they would raise
+class Transpiler
+{
+private:
+    std::ostream * m_out;
+    //Tracks which variables are defined at the statement being written, values are unused
+    VariableTable * m_variable_table;
+    unsigned int m_indent;
+    NUMBER_FORMAT m_number_format;
+    std::ostream & line();
+    void stmts(const NodeList<Stmt *> & stmts);
+    void block(const NodeList<Stmt *> & stmts);
+    void stmt(const Stmt * stmt);
+    void assign(const VariableExpression * variable_expression,const std::string & value);
+    std::string value(const Expression * expression);
+    std::string test(const Expression * expression);
+    std::string until(const Expression * expression);
+    std::string binary(const BinaryExpression * binary_expression,const std::string & type);
+    std::string operation(OPERATOR op,const std::string & left,const std::string & right) const;
+    std::string chain(const BinaryExpression * binary_expression);
+    std::string call(const CallExpression * call_expression);
+    bool can_throw(const Expression * expression) const;
+    std::string variable_name(const VariableExpression * variable_expression) const;
+    std::string decimal(sbasic_decimal_type decimal) const;
+    std::string quote(const std::string & str) const;
+public:
+    //Generated programs PRINT numbers like the interpreter does with the same format
+    Transpiler(NUMBER_FORMAT number_format) : m_out(nullptr), m_variable_table(nullptr), m_indent(0), m_number_format(number_format) {}
+    void transpile(const Program * program,const std::string & source_name,std::ostream & out);
+};
+}
+}
+
+#endif // TRANSPILER_H_INCLUDED
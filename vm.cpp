@@ -0,0 +1,142 @@
+#include "vm.h"
+#include "output.h"
+#include <cmath>
+#include <iostream>
+
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+VirtualMachine::VirtualMachine(const Bytecode & bytecode) : m_bytecode(bytecode), m_registers(bytecode.get_register_count())
+{
+    //Calls were bound when parsed, unknown functions fail when they are called
+    const std::vector<CallSite> & call_sites = bytecode.get_call_sites();
+    for(auto it = call_sites.begin(); it != call_sites.end(); ++it)
+    {
+        m_functions.push_back(it->function != nullptr ? it->function->pointer : nullptr);
+    }
+}
+
+void VirtualMachine::run()
+{
+    const std::vector<sbasic_decimal_type> & constants = m_bytecode.get_constants();
+    for(std::size_t i = 0; i < constants.size(); ++i)
+    {
+        m_registers[m_bytecode.get_constant_base() + i] = constants[i];
+    }
+
+    sbasic_decimal_type * r = m_registers.data();
+    const Instruction * code = m_bytecode.get_instructions().data();
+    const Instruction * ip = code;
+    for(;;)
+    {
+        const Instruction & ins = *ip++;
+        switch(ins.opcode)
+        {
+        case OPCODE::PLUS:
+            r[ins.a] = r[ins.b] + r[ins.c];
+            break;
+        case OPCODE::SUBSTRACT:
+            r[ins.a] = r[ins.b] - r[ins.c];
+            break;
+        case OPCODE::MULTIPLY:
+            r[ins.a] = r[ins.b] * r[ins.c];
+            break;
+        case OPCODE::DIVIDE:
+            r[ins.a] = r[ins.b] / r[ins.c];
+            break;
+        case OPCODE::DIVIDE_EXACTLY:
+            r[ins.a] = sbasic_divide_exactly(r[ins.b],r[ins.c]);
+            break;
+        case OPCODE::POWER:
+            r[ins.a] = std::pow(r[ins.b],r[ins.c]);
+            break;
+        case OPCODE::MOD:
+            r[ins.a] = sbasic_mod(r[ins.b],r[ins.c]);
+            break;
+        case OPCODE::EQUAL:
+            r[ins.a] = r[ins.b] == r[ins.c] ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::GREATER_THEN:
+            r[ins.a] = r[ins.b] > r[ins.c] ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::LESS_THEN:
+            r[ins.a] = r[ins.b] < r[ins.c] ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::NOT_EQUAL:
+            r[ins.a] = r[ins.b] != r[ins.c] ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::GREATER_THEN_OR_EQUAL:
+            r[ins.a] = r[ins.b] >= r[ins.c] ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::LESS_THEN_OR_EQUAL:
+            r[ins.a] = r[ins.b] <= r[ins.c] ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::MOVE:
+            r[ins.a] = r[ins.b];
+            break;
+        case OPCODE::NEGATE:
+            r[ins.a] = -r[ins.b];
+            break;
+        case OPCODE::NOT:
+            r[ins.a] = r[ins.b] == sbasic_false ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::TEST:
+            r[ins.a] = r[ins.b] == sbasic_true ? sbasic_true : sbasic_false;
+            break;
+        case OPCODE::CALL:
+        {
+            //The arguments are in consecutive registers, passed where they are
+            if(m_functions[ins.b] == nullptr)
+            {
+                throw "The \"" + m_bytecode.get_call_sites()[ins.b].function_name + "\" function not found";
+            }
+            r[ins.a] = m_functions[ins.b](r + ins.c);
+            break;
+        }
+        case OPCODE::PRINT:
+            standard_output.write_number(r[ins.a]);
+            standard_output.end_line();
+            break;
+        case OPCODE::PRINT_STRING:
+            standard_output.write(m_bytecode.get_strings()[ins.a]);
+            standard_output.end_line();
+            break;
+        case OPCODE::INPUT:
+            standard_output.before_input();
+            std::cin >> r[ins.a];
+            break;
+        case OPCODE::INPUT_PROMPT:
+            standard_output.write(m_bytecode.get_strings()[ins.a]);
+            standard_output.write("?",1);
+            break;
+        case OPCODE::JUMP:
+            ip = code + ins.a;
+            break;
+        case OPCODE::JUMP_IF_TRUE:
+            if(r[ins.a] == sbasic_true)
+            {
+                ip = code + ins.b;
+            }
+            break;
+        case OPCODE::JUMP_IF_NOT_TRUE:
+            if(r[ins.a] != sbasic_true)
+            {
+                ip = code + ins.b;
+            }
+            break;
+        case OPCODE::JUMP_IF_FALSE:
+            if(r[ins.a] == sbasic_false)
+            {
+                ip = code + ins.b;
+            }
+            break;
+        case OPCODE::ERROR:
+            throw m_bytecode.get_strings()[ins.a];
+        case OPCODE::HALT:
+            return;
+        }
+    }
+}
+}
+}
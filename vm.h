@@ -0,0 +1,26 @@
+#ifndef VM_H_INCLUDED
+#define VM_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include "language.h"
+#include "bytecode.h"
+namespace SBASIC
+{
+inline namespace SBASIC_NUMERIC
+{
+//VirtualMachine
+class VirtualMachine
+{
+private:
+    const Bytecode & m_bytecode;
+    std::vector<sbasic_decimal_type> m_registers;
+    std::vector<sbasic_function_pointer> m_functions;
+public:
+    VirtualMachine(const Bytecode & bytecode);
+    void run();
+};
+}
+}
+
+#endif // VM_H_INCLUDED